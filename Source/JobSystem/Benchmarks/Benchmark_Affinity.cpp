@@ -0,0 +1,143 @@
+// Partitioned per-frame updates with and without worker affinity hints
+
+#include "Benchmarks.h"
+#include "Jobs/JobSystem.h"
+
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+namespace SV::Benchmarks
+{
+	namespace
+	{
+		constexpr size_t CHUNK_FLOATS = 64 * 1024; // 256 KB, fits a typical L2
+		constexpr int32_t CHUNKS_PER_WORKER = 2;
+		constexpr int32_t FRAME_COUNT = 200;
+
+		// Counts cache misses of this process and of the worker threads created while it is open.
+		// Counts of inherited threads are added when they exit, so read after JobSystem::Shutdown.
+		class CacheMissCounter
+		{
+		public:
+			CacheMissCounter()
+			{
+#ifdef __linux__
+				perf_event_attr attr{};
+				attr.size = sizeof(attr);
+				attr.type = PERF_TYPE_HARDWARE;
+				attr.config = PERF_COUNT_HW_CACHE_MISSES;
+				attr.exclude_kernel = 1;
+				attr.inherit = 1;
+				m_Fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+			}
+
+			~CacheMissCounter()
+			{
+#ifdef __linux__
+				if (m_Fd >= 0)
+				{
+					close(m_Fd);
+				}
+#endif
+			}
+
+			bool IsValid() const { return m_Fd >= 0; }
+
+			uint64_t Read() const
+			{
+				uint64_t value = 0;
+#ifdef __linux__
+				if (m_Fd >= 0 && read(m_Fd, &value, sizeof(value)) != sizeof(value))
+				{
+					value = 0;
+				}
+#endif
+				return value;
+			}
+
+		private:
+			int m_Fd = -1;
+		};
+
+		struct AffinityResult
+		{
+			double FrameMs = 0.0;
+			uint64_t CacheMisses = 0;
+			bool bHasCacheMisses = false;
+		};
+
+		AffinityResult RunFrames(bool bUseAffinity)
+		{
+			CacheMissCounter counter;
+			JobSystem::Initialize();
+
+			const int32_t workerCount = JobSystem::Get().GetWorkerCount(EWorkerGroup::Foreground);
+			const int32_t chunkCount = workerCount * CHUNKS_PER_WORKER;
+			std::vector<std::vector<float>> chunks(chunkCount, std::vector<float>(CHUNK_FLOATS, 1.0f));
+
+			ScopedTimer timer;
+			for (int32_t frame = 0; frame < FRAME_COUNT; ++frame)
+			{
+				std::vector<std::shared_ptr<TaskEvent>> events;
+				events.reserve(chunkCount);
+				for (int32_t chunk = 0; chunk < chunkCount; ++chunk)
+				{
+					TaskParams params;
+					if (bUseAffinity)
+					{
+						params.PreferredWorker = chunk;
+					}
+					std::vector<float>* data = &chunks[chunk];
+					events.push_back(JobTask::CreateAndDispatch(
+						[data]()
+						{
+							// A few passes over the chunk, like integrate and resolve steps of a cell update
+							for (int32_t pass = 0; pass < 4; ++pass)
+							{
+								for (float& value : *data)
+								{
+									value = value * 0.999f + 0.001f;
+								}
+							}
+						}, {}, params));
+				}
+				TaskEvent::WaitAll(events);
+			}
+
+			AffinityResult result;
+			result.FrameMs = timer.GetElapsedMs() / FRAME_COUNT;
+			JobSystem::Shutdown();
+
+			result.bHasCacheMisses = counter.IsValid();
+			result.CacheMisses = counter.Read();
+			return result;
+		}
+	}
+
+	void Benchmark_Affinity()
+	{
+		std::cout << "  " << FRAME_COUNT << " frames, " << CHUNKS_PER_WORKER << " chunks of " << CHUNK_FLOATS * sizeof(float) / 1024 << " KB per worker\n";
+
+		AffinityResult unpinned = RunFrames(false);
+		AffinityResult pinned = RunFrames(true);
+
+		PrintResult("Frame time, any worker", unpinned.FrameMs, "ms");
+		PrintResult("Frame time, preferred worker", pinned.FrameMs, "ms");
+		if (unpinned.bHasCacheMisses && pinned.bHasCacheMisses)
+		{
+			PrintResult("Cache misses, any worker", static_cast<double>(unpinned.CacheMisses), "");
+			PrintResult("Cache misses, preferred worker", static_cast<double>(pinned.CacheMisses), "");
+		}
+		else
+		{
+			std::cout << "  Cache miss counters not available (perf_event_open)\n";
+		}
+	}
+}
@@ -0,0 +1,145 @@
+// Async file reads against blocking reads inside foreground worker tasks
+
+#include "Benchmarks.h"
+#include "Jobs/JobSystem.h"
+#include "IO/AsyncFileIO.h"
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include <random>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace SV::Benchmarks
+{
+	namespace
+	{
+		constexpr int32_t FILE_COUNT = 16;
+		constexpr uint64_t FILE_SIZE = 8ull * 1024 * 1024;
+		constexpr uint64_t CHUNK_SIZE = 512ull * 1024;
+
+		std::vector<std::string> CreateFiles(const std::filesystem::path& directory)
+		{
+			std::filesystem::create_directories(directory);
+			std::vector<char> data(FILE_SIZE);
+			std::mt19937 random(42);
+			for (char& value : data)
+			{
+				value = static_cast<char>(random());
+			}
+
+			std::vector<std::string> paths;
+			for (int32_t i = 0; i < FILE_COUNT; ++i)
+			{
+				std::string path = (directory / ("Chunk_" + std::to_string(i) + ".bin")).string();
+				std::ofstream file(path, std::ios::binary);
+				file.write(data.data(), static_cast<std::streamsize>(data.size()));
+				paths.push_back(path);
+			}
+			return paths;
+		}
+
+		// Cold reads where the platform allows it, otherwise the page cache is measured
+		void DropPageCache(const std::vector<std::string>& paths)
+		{
+#ifdef __linux__
+			for (const std::string& path : paths)
+			{
+				int fd = open(path.c_str(), O_RDONLY);
+				if (fd >= 0)
+				{
+					fdatasync(fd);
+					posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+					close(fd);
+				}
+			}
+#else
+			(void)paths;
+#endif
+		}
+
+		std::vector<AsyncReadDesc> BuildReads(const std::vector<std::string>& paths, std::vector<uint8_t>& buffer, EAsyncReadMode mode)
+		{
+			std::vector<AsyncReadDesc> reads;
+			for (size_t fileIndex = 0; fileIndex < paths.size(); ++fileIndex)
+			{
+				for (uint64_t offset = 0; offset < FILE_SIZE; offset += CHUNK_SIZE)
+				{
+					AsyncReadDesc desc;
+					desc.Path = paths[fileIndex];
+					desc.Offset = offset;
+					desc.Size = CHUNK_SIZE;
+					desc.Buffer = buffer.data() + fileIndex * FILE_SIZE + offset;
+					desc.Mode = mode;
+					reads.push_back(desc);
+				}
+			}
+			return reads;
+		}
+
+		double RunBlockingInWorkers(const std::vector<AsyncReadDesc>& reads)
+		{
+			ScopedTimer timer;
+			std::vector<std::shared_ptr<TaskEvent>> events;
+			for (const AsyncReadDesc& desc : reads)
+			{
+				events.push_back(JobTask::CreateAndDispatch(
+					[&desc]()
+					{
+						std::ifstream file(desc.Path, std::ios::binary);
+						file.seekg(static_cast<std::streamoff>(desc.Offset));
+						file.read(static_cast<char*>(desc.Buffer), static_cast<std::streamsize>(desc.Size));
+					}));
+			}
+			TaskEvent::WaitAll(events);
+			return timer.GetElapsedMs();
+		}
+
+		double RunAsync(AsyncFileIO& fileIO, const std::vector<AsyncReadDesc>& reads)
+		{
+			ScopedTimer timer;
+			std::vector<std::shared_ptr<TaskEvent>> events = fileIO.ReadBatchAsync(reads);
+			TaskEvent::WaitAll(events);
+			return timer.GetElapsedMs();
+		}
+	}
+
+	void Benchmark_AsyncIO()
+	{
+		JobSystem::Initialize();
+
+		std::filesystem::path directory = std::filesystem::temp_directory_path() / "JobSystemAsyncIOBenchmark";
+		std::vector<std::string> paths = CreateFiles(directory);
+		std::vector<uint8_t> buffer(FILE_COUNT * FILE_SIZE);
+		const double totalMb = static_cast<double>(buffer.size()) / (1024.0 * 1024.0);
+
+		std::cout << "  " << FILE_COUNT << " files, " << totalMb << " MB in " << CHUNK_SIZE / 1024 << " KB reads\n";
+
+		DropPageCache(paths);
+		double blockingMs = RunBlockingInWorkers(BuildReads(paths, buffer, EAsyncReadMode::Stream));
+		PrintResult("Blocking reads in workers", totalMb / (blockingMs / 1000.0), "MB/s");
+
+		{
+			AsyncFileIO defaultIO(EAsyncIOBackend::Auto);
+			DropPageCache(paths);
+			double asyncMs = RunAsync(defaultIO, BuildReads(paths, buffer, EAsyncReadMode::Stream));
+			PrintResult(std::string("ReadAsync (") + defaultIO.GetBackendName() + ")", totalMb / (asyncMs / 1000.0), "MB/s");
+
+			AsyncFileIO threadPoolIO(EAsyncIOBackend::ThreadPool);
+			DropPageCache(paths);
+			double threadPoolMs = RunAsync(threadPoolIO, BuildReads(paths, buffer, EAsyncReadMode::Stream));
+			PrintResult("ReadAsync (IO worker group)", totalMb / (threadPoolMs / 1000.0), "MB/s");
+
+			DropPageCache(paths);
+			double mappedMs = RunAsync(defaultIO, BuildReads(paths, buffer, EAsyncReadMode::MemoryMapped));
+			PrintResult("ReadAsync (memory mapped)", totalMb / (mappedMs / 1000.0), "MB/s");
+		}
+
+		std::filesystem::remove_all(directory);
+		JobSystem::Shutdown();
+	}
+}
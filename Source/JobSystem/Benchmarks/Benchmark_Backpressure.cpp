@@ -0,0 +1,110 @@
+// A producer dispatching far more tasks than the workers keep up with, unbounded queues against bounded ones
+// under each backpressure policy
+
+#include "Benchmarks.h"
+#include "Jobs/JobSystem.h"
+#include "Jobs/TaskGroup.h"
+#include "Platform/Platform.h"
+
+#include <atomic>
+#include <string>
+
+namespace SV::Benchmarks
+{
+	namespace
+	{
+		constexpr int32_t TASK_COUNT = 200000;
+		constexpr int32_t TASK_WORK = 200;
+		constexpr size_t QUEUE_CAPACITY = 256;
+		constexpr uint32_t GROUP_CAPACITY = 64;
+
+		void BusyWork(std::atomic<int32_t>& doneCount)
+		{
+			volatile uint64_t value = 0;
+			for (int32_t i = 0; i < TASK_WORK; ++i)
+			{
+				value = value + i;
+			}
+			doneCount.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		const char* GetPolicyName(EBackpressurePolicy policy)
+		{
+			switch (policy)
+			{
+			case EBackpressurePolicy::RunInline: return "RunInline";
+			case EBackpressurePolicy::HelpDrain: return "HelpDrain";
+			case EBackpressurePolicy::Block: return "Block";
+			}
+			return "Unknown";
+		}
+
+		void RunProducer(const std::string& name, size_t capacity, EBackpressurePolicy policy)
+		{
+			JobSystemConfig config = JobSystemConfig::Default();
+			config[EWorkerGroup::Foreground].QueueCapacity = capacity;
+			config[EWorkerGroup::Foreground].BackpressurePolicy = policy;
+			JobSystem::Initialize(config);
+
+			std::atomic<int32_t> doneCount{ 0 };
+			ScopedTimer timer;
+			for (int32_t i = 0; i < TASK_COUNT; ++i)
+			{
+				JobTask::CreateAndDispatch([&doneCount]() { BusyWork(doneCount); });
+			}
+			while (doneCount.load(std::memory_order_relaxed) != TASK_COUNT)
+			{
+				Platform::YieldThread();
+			}
+			const double elapsedMs = timer.GetElapsedMs();
+
+			const JobSystemStats stats = JobSystem::Get().GetStats(EWorkerGroup::Foreground);
+			PrintResult(name, elapsedMs, "ms");
+			std::cout << "    queue high-water mark " << stats.GlobalQueueHighWaterMark << ", backpressure hits " << stats.BackpressureCount << "\n";
+			JobSystem::Shutdown();
+		}
+
+		void RunGroupProducer(const std::string& name, uint32_t capacity, EBackpressurePolicy policy)
+		{
+			JobSystem::Initialize();
+
+			std::atomic<int32_t> doneCount{ 0 };
+			uint32_t highWaterMark = 0;
+			double elapsedMs = 0.0;
+			JobTask::CreateAndDispatch([&]()
+				{
+					ScopedTimer timer;
+					TaskGroup group(ETaskSpawnMode::Queued);
+					group.SetCapacity(capacity, policy);
+					for (int32_t i = 0; i < TASK_COUNT; ++i)
+					{
+						group.Spawn([&doneCount]() { BusyWork(doneCount); });
+					}
+					group.Wait();
+					elapsedMs = timer.GetElapsedMs();
+					highWaterMark = group.GetHighWaterMark();
+				})->Wait();
+
+			PrintResult(name, elapsedMs, "ms");
+			std::cout << "    outstanding high-water mark " << highWaterMark << "\n";
+			JobSystem::Shutdown();
+		}
+	}
+
+	void Benchmark_Backpressure()
+	{
+		std::cout << "  " << TASK_COUNT << " tasks launched from the main thread, queue capacity " << QUEUE_CAPACITY << "\n";
+		RunProducer("Unbounded", 0, EBackpressurePolicy::RunInline);
+		for (EBackpressurePolicy policy : { EBackpressurePolicy::RunInline, EBackpressurePolicy::HelpDrain, EBackpressurePolicy::Block })
+		{
+			RunProducer(std::string("Bounded, ") + GetPolicyName(policy), QUEUE_CAPACITY, policy);
+		}
+
+		std::cout << "  " << TASK_COUNT << " branches spawned into one task group on a worker, capacity " << GROUP_CAPACITY << "\n";
+		RunGroupProducer("Group unbounded", 0, EBackpressurePolicy::RunInline);
+		for (EBackpressurePolicy policy : { EBackpressurePolicy::RunInline, EBackpressurePolicy::HelpDrain })
+		{
+			RunGroupProducer(std::string("Group bounded, ") + GetPolicyName(policy), GROUP_CAPACITY, policy);
+		}
+	}
+}
@@ -0,0 +1,95 @@
+// Joining a large fan-out into one continuation, an event per child against the counter of a task group
+
+#include "Benchmarks.h"
+#include "Jobs/JobSystem.h"
+#include "Jobs/TaskGroup.h"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+namespace SV::Benchmarks
+{
+	namespace
+	{
+		constexpr int32_t CHILD_COUNT = 10000;
+		constexpr int32_t REPEAT_COUNT = 5;
+
+		void Child(std::atomic<int32_t>& doneCount)
+		{
+			doneCount.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		void Continuation(std::atomic<int32_t>& doneCount)
+		{
+			if (doneCount.load(std::memory_order_relaxed) != CHILD_COUNT)
+			{
+				std::cout << "  Continuation ran early\n";
+			}
+		}
+
+		double JoinWithEvents()
+		{
+			std::atomic<int32_t> doneCount{ 0 };
+			ScopedTimer timer;
+			std::vector<std::shared_ptr<TaskEvent>> children;
+			children.reserve(CHILD_COUNT);
+			for (int32_t i = 0; i < CHILD_COUNT; ++i)
+			{
+				children.push_back(JobTask::CreateAndDispatch([&doneCount]() { Child(doneCount); }));
+			}
+			JobTask::CreateAndDispatch([&doneCount]() { Continuation(doneCount); }, children)->Wait();
+			return timer.GetElapsedMs();
+		}
+
+		double JoinWithGroupContinuation()
+		{
+			std::atomic<int32_t> doneCount{ 0 };
+			ScopedTimer timer;
+			TaskGroup group(ETaskSpawnMode::Queued);
+			for (int32_t i = 0; i < CHILD_COUNT; ++i)
+			{
+				group.Spawn([&doneCount]() { Child(doneCount); });
+			}
+			group.Then([&doneCount]() { Continuation(doneCount); })->Wait();
+			return timer.GetElapsedMs();
+		}
+
+		double JoinWithGroupWait()
+		{
+			std::atomic<int32_t> doneCount{ 0 };
+			ScopedTimer timer;
+			TaskGroup group(ETaskSpawnMode::Queued);
+			for (int32_t i = 0; i < CHILD_COUNT; ++i)
+			{
+				group.Spawn([&doneCount]() { Child(doneCount); });
+			}
+			group.Wait();
+			Continuation(doneCount);
+			return timer.GetElapsedMs();
+		}
+
+		// Best of a few runs, joined from a task like a real workload
+		double MeasureInTask(double (*join)())
+		{
+			double bestMs = 0.0;
+			for (int32_t i = 0; i < REPEAT_COUNT; ++i)
+			{
+				double elapsedMs = 0.0;
+				JobTask::CreateAndDispatch([&]() { elapsedMs = join(); })->Wait();
+				bestMs = i == 0 ? elapsedMs : std::min(bestMs, elapsedMs);
+			}
+			return bestMs;
+		}
+	}
+
+	void Benchmark_FanIn()
+	{
+		JobSystem::Initialize();
+		std::cout << "  " << CHILD_COUNT << " children joined into one continuation\n";
+		PrintResult("Event per child", MeasureInTask(JoinWithEvents), "ms");
+		PrintResult("TaskGroup::Then", MeasureInTask(JoinWithGroupContinuation), "ms");
+		PrintResult("TaskGroup::Wait", MeasureInTask(JoinWithGroupWait), "ms");
+		JobSystem::Shutdown();
+	}
+}
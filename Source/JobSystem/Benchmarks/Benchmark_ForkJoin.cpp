@@ -0,0 +1,132 @@
+// Recursive divide and conquer, spawning both halves as events against work-first ParallelInvoke
+
+#include "Benchmarks.h"
+#include "Jobs/JobSystem.h"
+#include "Jobs/TaskGroup.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace SV::Benchmarks
+{
+	namespace
+	{
+		constexpr int32_t FIB_N = 25;
+		constexpr int32_t FIB_CUTOFF = 10;
+		constexpr size_t SORT_COUNT = 1 << 20;
+		constexpr size_t SORT_CUTOFF = 2048;
+		constexpr int32_t REPEAT_COUNT = 3;
+
+		uint64_t SerialFib(int32_t n)
+		{
+			return n < 2 ? n : SerialFib(n - 1) + SerialFib(n - 2);
+		}
+
+		uint64_t EventFib(int32_t n)
+		{
+			if (n < FIB_CUTOFF)
+			{
+				return SerialFib(n);
+			}
+			uint64_t a = 0;
+			uint64_t b = 0;
+			std::shared_ptr<TaskEvent> left = JobTask::CreateAndDispatch([&a, n]() { a = EventFib(n - 1); });
+			std::shared_ptr<TaskEvent> right = JobTask::CreateAndDispatch([&b, n]() { b = EventFib(n - 2); });
+			left->Wait();
+			right->Wait();
+			return a + b;
+		}
+
+		uint64_t InvokeFib(int32_t n)
+		{
+			if (n < FIB_CUTOFF)
+			{
+				return SerialFib(n);
+			}
+			uint64_t a = 0;
+			uint64_t b = 0;
+			ParallelInvoke([&a, n]() { a = InvokeFib(n - 1); }, [&b, n]() { b = InvokeFib(n - 2); });
+			return a + b;
+		}
+
+		template<typename TSortHalves>
+		void QuickSort(int32_t* begin, int32_t* end, TSortHalves&& sortHalves)
+		{
+			if (static_cast<size_t>(end - begin) <= SORT_CUTOFF)
+			{
+				std::sort(begin, end);
+				return;
+			}
+			const int32_t pivot = begin[(end - begin) / 2];
+			int32_t* middle = std::partition(begin, end, [pivot](int32_t value) { return value < pivot; });
+			int32_t* upper = std::partition(middle, end, [pivot](int32_t value) { return value == pivot; });
+			sortHalves(begin, middle, upper, end);
+		}
+
+		void EventSort(int32_t* begin, int32_t* end)
+		{
+			QuickSort(begin, end, [](int32_t* lowBegin, int32_t* lowEnd, int32_t* highBegin, int32_t* highEnd)
+				{
+					std::shared_ptr<TaskEvent> low = JobTask::CreateAndDispatch([=]() { EventSort(lowBegin, lowEnd); });
+					std::shared_ptr<TaskEvent> high = JobTask::CreateAndDispatch([=]() { EventSort(highBegin, highEnd); });
+					low->Wait();
+					high->Wait();
+				});
+		}
+
+		void InvokeSort(int32_t* begin, int32_t* end)
+		{
+			QuickSort(begin, end, [](int32_t* lowBegin, int32_t* lowEnd, int32_t* highBegin, int32_t* highEnd)
+				{
+					ParallelInvoke([=]() { InvokeSort(lowBegin, lowEnd); }, [=]() { InvokeSort(highBegin, highEnd); });
+				});
+		}
+
+		// Best of a few runs, started from a task like a real workload
+		template<typename TRun>
+		double MeasureInTask(TRun&& run)
+		{
+			double bestMs = 0.0;
+			for (int32_t i = 0; i < REPEAT_COUNT; ++i)
+			{
+				double elapsedMs = 0.0;
+				JobTask::CreateAndDispatch([&]()
+					{
+						ScopedTimer timer;
+						run();
+						elapsedMs = timer.GetElapsedMs();
+					})->Wait();
+				bestMs = i == 0 ? elapsedMs : std::min(bestMs, elapsedMs);
+			}
+			return bestMs;
+		}
+	}
+
+	void Benchmark_ForkJoin()
+	{
+		JobSystem::Initialize();
+		std::cout << "  fib(" << FIB_N << ") with serial cutoff " << FIB_CUTOFF << ", quicksort of " << SORT_COUNT << " ints\n";
+
+		uint64_t result = 0;
+		PrintResult("Fib, event per branch", MeasureInTask([&result]() { result = EventFib(FIB_N); }), "ms");
+		PrintResult("Fib, ParallelInvoke", MeasureInTask([&result]() { result = InvokeFib(FIB_N); }), "ms");
+		if (result != SerialFib(FIB_N))
+		{
+			std::cout << "  Fib result mismatch\n";
+		}
+
+		std::vector<int32_t> source(SORT_COUNT);
+		std::mt19937 random(42);
+		std::generate(source.begin(), source.end(), [&random]() { return static_cast<int32_t>(random()); });
+		std::vector<int32_t> values;
+		PrintResult("Quicksort, event per branch", MeasureInTask([&]() { values = source; EventSort(values.data(), values.data() + values.size()); }), "ms");
+		PrintResult("Quicksort, ParallelInvoke", MeasureInTask([&]() { values = source; InvokeSort(values.data(), values.data() + values.size()); }), "ms");
+		if (!std::is_sorted(values.begin(), values.end()))
+		{
+			std::cout << "  Quicksort result not sorted\n";
+		}
+
+		JobSystem::Shutdown();
+	}
+}
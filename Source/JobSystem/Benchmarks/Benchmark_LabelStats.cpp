@@ -0,0 +1,57 @@
+// Cost of the per-label histograms on tiny tasks, unlabeled against labeled with the stats off and on
+
+#include "Benchmarks.h"
+#include "Jobs/JobSystem.h"
+#include "Jobs/TaskGroup.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace SV::Benchmarks
+{
+	namespace
+	{
+		constexpr int32_t TASK_COUNT = 200000;
+		constexpr int32_t REPEAT_COUNT = 3;
+
+		double MeasureTasks(bool bLabelStats, const char* label, std::atomic<int64_t>& checksum)
+		{
+			JobSystemConfig config = JobSystemConfig::Default();
+			config.bLabelStats = bLabelStats;
+			JobSystem::Initialize(config);
+
+			TaskParams params;
+			params.Label = label;
+			double bestMs = 0.0;
+			for (int32_t i = 0; i < REPEAT_COUNT; ++i)
+			{
+				ScopedTimer timer;
+				TaskGroup group(ETaskSpawnMode::Queued, params);
+				for (int32_t task = 0; task < TASK_COUNT; ++task)
+				{
+					group.Spawn([&checksum, task]() { checksum.fetch_add(task, std::memory_order_relaxed); });
+				}
+				group.Wait();
+				const double elapsedMs = timer.GetElapsedMs();
+				bestMs = i == 0 ? elapsedMs : std::min(bestMs, elapsedMs);
+			}
+
+			if (TaskLabelStats* labelStats = JobSystem::Get().GetLabelStats(); labelStats && label)
+			{
+				TaskLabelStats::PrintReport(labelStats->GetReport(), std::cout);
+			}
+			JobSystem::Shutdown();
+			return bestMs;
+		}
+	}
+
+	void Benchmark_LabelStats()
+	{
+		std::cout << "  " << TASK_COUNT << " empty tasks per run\n";
+
+		std::atomic<int64_t> checksum{ 0 };
+		PrintResult("Unlabeled", MeasureTasks(true, nullptr, checksum), "ms");
+		PrintResult("Labeled, stats off", MeasureTasks(false, "Tiny", checksum), "ms");
+		PrintResult("Labeled, stats on", MeasureTasks(true, "Tiny", checksum), "ms");
+	}
+}
@@ -0,0 +1,81 @@
+// Short critical sections under contention, at the core count and oversubscribed so lock holders get descheduled
+
+#include "Benchmarks.h"
+#include "Platform/Platform.h"
+#include "Threading/Synchronization.h"
+
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace SV::Benchmarks
+{
+	namespace
+	{
+		constexpr int32_t OPERATIONS_PER_THREAD = 200000;
+		constexpr int32_t OVERSUBSCRIPTION = 4;
+
+		struct StdMutexLock
+		{
+			void Lock() { m_Mutex.lock(); }
+			void Unlock() { m_Mutex.unlock(); }
+			std::mutex m_Mutex;
+		};
+
+		template<typename TLock>
+		double RunContended(int32_t threadCount)
+		{
+			TLock lock;
+			uint64_t counter = 0;
+			std::vector<std::thread> threads;
+			threads.reserve(threadCount);
+
+			ScopedTimer timer;
+			for (int32_t i = 0; i < threadCount; ++i)
+			{
+				threads.emplace_back([&lock, &counter]()
+					{
+						for (int32_t operation = 0; operation < OPERATIONS_PER_THREAD; ++operation)
+						{
+							lock.Lock();
+							++counter;
+							lock.Unlock();
+						}
+					});
+			}
+			for (std::thread& thread : threads)
+			{
+				thread.join();
+			}
+			const double ms = timer.GetElapsedMs();
+
+			if (counter != static_cast<uint64_t>(threadCount) * OPERATIONS_PER_THREAD)
+			{
+				std::cout << "  Lost updates, counter is " << counter << "\n";
+			}
+			return ms * 1000000.0 / (static_cast<double>(threadCount) * OPERATIONS_PER_THREAD);
+		}
+
+		void RunAll(int32_t threadCount)
+		{
+			std::cout << "  " << threadCount << " threads:\n";
+			PrintResult("std::mutex", RunContended<StdMutexLock>(threadCount), "ns/op");
+			PrintResult("SpinLock", RunContended<SpinLock>(threadCount), "ns/op");
+			PrintResult("AdaptiveLock", RunContended<AdaptiveLock>(threadCount), "ns/op");
+		}
+	}
+
+	void Benchmark_Locks()
+	{
+		const int32_t coreCount = std::max(2, Platform::GetLogicalCoreCount());
+		RunAll(coreCount);
+		RunAll(coreCount * OVERSUBSCRIPTION);
+
+#if SV_LOCK_CONTENTION_STATS
+		LockContentionStats stats = AdaptiveLock::GetGlobalStats();
+		std::cout << "  AdaptiveLock: " << stats.Acquires << " acquires, " << stats.ContendedAcquires << " contended, "
+			<< stats.Sleeps << " sleeps\n";
+#endif
+	}
+}
@@ -0,0 +1,196 @@
+// SoA particle integration, aligned chunks with SSE/AVX2 kernels against a per-index loop split evenly across workers
+
+#include "Benchmarks.h"
+#include "Jobs/JobSystem.h"
+#include "Jobs/ParallelFor.h"
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SV_BENCHMARK_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define SV_TARGET_AVX2
+#else
+#define SV_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#else
+#define SV_BENCHMARK_X86 0
+#endif
+
+namespace SV::Benchmarks
+{
+	namespace
+	{
+		constexpr size_t PARTICLE_COUNT = 1 << 21;
+		constexpr int32_t ITERATION_COUNT = 10;
+		constexpr float DELTA_TIME = 1.0f / 60.0f;
+
+		struct Particles
+		{
+			AlignedArray<float> PositionX, PositionY, PositionZ;
+			AlignedArray<float> VelocityX, VelocityY, VelocityZ;
+
+			void Reset()
+			{
+				for (AlignedArray<float>* stream : { &PositionX, &PositionY, &PositionZ, &VelocityX, &VelocityY, &VelocityZ })
+				{
+					stream->resize(PARTICLE_COUNT);
+				}
+				for (size_t i = 0; i < PARTICLE_COUNT; ++i)
+				{
+					PositionX[i] = PositionY[i] = PositionZ[i] = 0.0f;
+					VelocityX[i] = static_cast<float>(i % 7);
+					VelocityY[i] = static_cast<float>(i % 11);
+					VelocityZ[i] = static_cast<float>(i % 13);
+				}
+			}
+
+			double Checksum() const
+			{
+				double sum = 0.0;
+				for (size_t i = 0; i < PARTICLE_COUNT; ++i)
+				{
+					sum += PositionX[i] + PositionY[i] + PositionZ[i];
+				}
+				return sum;
+			}
+		};
+
+		void IntegrateScalar(float* px, float* py, float* pz, const float* vx, const float* vy, const float* vz, size_t count)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				px[i] += vx[i] * DELTA_TIME;
+				py[i] += vy[i] * DELTA_TIME;
+				pz[i] += vz[i] * DELTA_TIME;
+			}
+		}
+
+#if SV_BENCHMARK_X86
+		// Chunks start aligned, so only the last chunk has a scalar tail. No FMA, results match the scalar loop exactly
+		void IntegrateSSE(float* px, float* py, float* pz, const float* vx, const float* vy, const float* vz, size_t count)
+		{
+			const __m128 dt = _mm_set1_ps(DELTA_TIME);
+			size_t i = 0;
+			for (; i + 4 <= count; i += 4)
+			{
+				_mm_store_ps(px + i, _mm_add_ps(_mm_load_ps(px + i), _mm_mul_ps(_mm_load_ps(vx + i), dt)));
+				_mm_store_ps(py + i, _mm_add_ps(_mm_load_ps(py + i), _mm_mul_ps(_mm_load_ps(vy + i), dt)));
+				_mm_store_ps(pz + i, _mm_add_ps(_mm_load_ps(pz + i), _mm_mul_ps(_mm_load_ps(vz + i), dt)));
+			}
+			IntegrateScalar(px + i, py + i, pz + i, vx + i, vy + i, vz + i, count - i);
+		}
+
+		SV_TARGET_AVX2 void IntegrateAVX2(float* px, float* py, float* pz, const float* vx, const float* vy, const float* vz, size_t count)
+		{
+			const __m256 dt = _mm256_set1_ps(DELTA_TIME);
+			size_t i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				_mm256_store_ps(px + i, _mm256_add_ps(_mm256_load_ps(px + i), _mm256_mul_ps(_mm256_load_ps(vx + i), dt)));
+				_mm256_store_ps(py + i, _mm256_add_ps(_mm256_load_ps(py + i), _mm256_mul_ps(_mm256_load_ps(vy + i), dt)));
+				_mm256_store_ps(pz + i, _mm256_add_ps(_mm256_load_ps(pz + i), _mm256_mul_ps(_mm256_load_ps(vz + i), dt)));
+			}
+			IntegrateScalar(px + i, py + i, pz + i, vx + i, vy + i, vz + i, count - i);
+		}
+
+		bool HasAVX2()
+		{
+#if defined(_MSC_VER) && !defined(__clang__)
+			int registers[4];
+			__cpuidex(registers, 7, 0);
+			return (registers[1] & (1 << 5)) != 0;
+#else
+			return __builtin_cpu_supports("avx2");
+#endif
+		}
+#endif
+
+		// What a generic parallel for does: equal ranges regardless of alignment, the body is called per index
+		void ParallelForEachIndex(size_t count, const std::function<void(size_t)>& body)
+		{
+			const size_t rangeCount = static_cast<size_t>(JobSystem::Get().GetWorkerCount(EWorkerGroup::Foreground)) * 4;
+			std::vector<std::shared_ptr<TaskEvent>> events;
+			for (size_t range = 0; range < rangeCount; ++range)
+			{
+				const size_t begin = count * range / rangeCount;
+				const size_t end = count * (range + 1) / rangeCount;
+				events.push_back(JobTask::CreateAndDispatch([&body, begin, end]()
+					{
+						for (size_t i = begin; i < end; ++i)
+						{
+							body(i);
+						}
+					}));
+			}
+			TaskEvent::WaitAll(events);
+		}
+
+		using Kernel = void(*)(float*, float*, float*, const float*, const float*, const float*, size_t);
+
+		double RunChunked(Particles& particles, Kernel kernel)
+		{
+			particles.Reset();
+			ScopedTimer timer;
+			for (int32_t iteration = 0; iteration < ITERATION_COUNT; ++iteration)
+			{
+				ParallelForChunks(PARTICLE_COUNT, kernel,
+					particles.PositionX.data(), particles.PositionY.data(), particles.PositionZ.data(),
+					particles.VelocityX.data(), particles.VelocityY.data(), particles.VelocityZ.data());
+			}
+			return timer.GetElapsedMs();
+		}
+
+		double RunPerIndex(Particles& particles)
+		{
+			particles.Reset();
+			ScopedTimer timer;
+			for (int32_t iteration = 0; iteration < ITERATION_COUNT; ++iteration)
+			{
+				ParallelForEachIndex(PARTICLE_COUNT, [&particles](size_t i)
+					{
+						particles.PositionX[i] += particles.VelocityX[i] * DELTA_TIME;
+						particles.PositionY[i] += particles.VelocityY[i] * DELTA_TIME;
+						particles.PositionZ[i] += particles.VelocityZ[i] * DELTA_TIME;
+					});
+			}
+			return timer.GetElapsedMs();
+		}
+
+		void PrintRun(const std::string& name, double ms, const Particles& particles, double expectedChecksum)
+		{
+			const double nsPerParticle = ms * 1000000.0 / (static_cast<double>(PARTICLE_COUNT) * ITERATION_COUNT);
+			PrintResult(name, nsPerParticle, "ns/particle");
+			if (particles.Checksum() != expectedChecksum)
+			{
+				std::cout << "  " << name << " produced different results!\n";
+			}
+		}
+	}
+
+	void Benchmark_ParallelForChunks()
+	{
+		JobSystem::Initialize();
+
+		Particles particles;
+		std::cout << "  " << PARTICLE_COUNT << " particles in 6 float streams, " << ITERATION_COUNT << " iterations\n";
+
+		double perIndexMs = RunPerIndex(particles);
+		const double expectedChecksum = particles.Checksum();
+		PrintRun("Per-index, even split", perIndexMs, particles, expectedChecksum);
+		PrintRun("Aligned chunks, scalar", RunChunked(particles, IntegrateScalar), particles, expectedChecksum);
+#if SV_BENCHMARK_X86
+		PrintRun("Aligned chunks, SSE", RunChunked(particles, IntegrateSSE), particles, expectedChecksum);
+		if (HasAVX2())
+		{
+			PrintRun("Aligned chunks, AVX2", RunChunked(particles, IntegrateAVX2), particles, expectedChecksum);
+		}
+#endif
+
+		JobSystem::Shutdown();
+	}
+}
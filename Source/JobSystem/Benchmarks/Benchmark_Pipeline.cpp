@@ -0,0 +1,146 @@
+// Streaming decompress, parse, transform and write over fixed size blocks, serial loop against Pipeline with a
+// few token counts. Write is serial in order and checks that blocks arrive in input order
+
+#include "Benchmarks.h"
+#include "Jobs/JobSystem.h"
+#include "Jobs/Pipeline.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SV::Benchmarks
+{
+	namespace
+	{
+		constexpr int32_t BLOCK_COUNT = 2000;
+		constexpr size_t BLOCK_SIZE = 16 * 1024;
+		constexpr int32_t DECOMPRESS_PASSES = 8;
+		constexpr int32_t REPEAT_COUNT = 3;
+
+		struct Block
+		{
+			int32_t Index = 0;
+			std::vector<uint32_t> Data;
+			uint64_t Sum = 0;
+		};
+
+		struct Stream
+		{
+			int32_t NextIndex = 0;
+			int32_t NextWrite = 0;
+			uint64_t Checksum = 0;
+			bool bOutOfOrder = false;
+
+			bool Read(Block& block)
+			{
+				if (NextIndex == BLOCK_COUNT)
+				{
+					return false;
+				}
+				block.Index = NextIndex++;
+				block.Data.assign(BLOCK_SIZE / sizeof(uint32_t), 0);
+				return true;
+			}
+
+			void Write(const Block& block)
+			{
+				bOutOfOrder |= block.Index != NextWrite++;
+				Checksum = Checksum * 31 + block.Sum;
+			}
+		};
+
+		// Heaviest stage, stands in for decompression
+		void Decompress(Block& block)
+		{
+			uint32_t state = static_cast<uint32_t>(block.Index) * 2654435761u;
+			for (int32_t pass = 0; pass < DECOMPRESS_PASSES; ++pass)
+			{
+				for (uint32_t& value : block.Data)
+				{
+					state = state * 1664525u + 1013904223u;
+					value ^= state;
+				}
+			}
+		}
+
+		void Parse(Block& block)
+		{
+			std::sort(block.Data.begin(), block.Data.begin() + block.Data.size() / 8);
+		}
+
+		void Transform(Block& block)
+		{
+			uint64_t sum = 0;
+			for (uint32_t value : block.Data)
+			{
+				sum += value >> 3;
+			}
+			block.Sum = sum;
+		}
+
+		template<typename TRun>
+		double MeasureBlocksPerSecond(TRun&& run, uint64_t& outChecksum, bool& bOutOfOrder)
+		{
+			double bestMs = 0.0;
+			for (int32_t i = 0; i < REPEAT_COUNT; ++i)
+			{
+				Stream stream;
+				ScopedTimer timer;
+				run(stream);
+				const double elapsedMs = timer.GetElapsedMs();
+				bestMs = i == 0 ? elapsedMs : std::min(bestMs, elapsedMs);
+				outChecksum = stream.Checksum;
+				bOutOfOrder |= stream.bOutOfOrder;
+			}
+			return BLOCK_COUNT / (bestMs / 1000.0);
+		}
+	}
+
+	void Benchmark_Pipeline()
+	{
+		JobSystem::Initialize();
+		std::cout << "  " << BLOCK_COUNT << " blocks of " << BLOCK_SIZE / 1024 << " KiB, parallel decompress, parse and transform, in order write\n";
+
+		uint64_t serialChecksum = 0;
+		bool bOutOfOrder = false;
+		PrintResult("Serial loop", MeasureBlocksPerSecond([](Stream& stream)
+			{
+				Block block;
+				while (stream.Read(block))
+				{
+					Decompress(block);
+					Parse(block);
+					Transform(block);
+					stream.Write(block);
+				}
+			}, serialChecksum, bOutOfOrder), "blocks/s");
+
+		const size_t workerCount = static_cast<size_t>(JobSystem::Get().GetWorkerCount(EWorkerGroup::Foreground));
+		for (size_t tokenCount : { size_t(1), std::max<size_t>(2, workerCount), std::max<size_t>(2, workerCount) * 4 })
+		{
+			uint64_t checksum = 0;
+			const double blocksPerSecond = MeasureBlocksPerSecond([tokenCount](Stream& stream)
+				{
+					Pipeline<Block>(tokenCount)
+						.Input([&stream](Block& block) { return stream.Read(block); })
+						.Stage(EPipelineStageMode::Parallel, Decompress)
+						.Stage(EPipelineStageMode::Parallel, Parse)
+						.Stage(EPipelineStageMode::Parallel, Transform)
+						.Stage(EPipelineStageMode::SerialInOrder, [&stream](Block& block) { stream.Write(block); })
+						.Run();
+				}, checksum, bOutOfOrder);
+			PrintResult("Pipeline, " + std::to_string(tokenCount) + " tokens", blocksPerSecond, "blocks/s");
+			if (checksum != serialChecksum)
+			{
+				std::cout << "  Pipeline checksum mismatch\n";
+			}
+		}
+		if (bOutOfOrder)
+		{
+			std::cout << "  Blocks written out of order\n";
+		}
+		JobSystem::Shutdown();
+	}
+}
@@ -0,0 +1,60 @@
+// Long dependency chains with continuation inlining against always queuing the next link
+
+#include "Benchmarks.h"
+#include "Jobs/JobSystem.h"
+
+#include <vector>
+
+namespace SV::Benchmarks
+{
+	namespace
+	{
+		constexpr int32_t CHAIN_LENGTH = 20000;
+		constexpr int32_t CHAIN_COUNT = 4;
+
+		double RunChains(ETaskFlags flags)
+		{
+			TaskParams params;
+			params.Flags = flags;
+
+			std::vector<uint64_t> values(CHAIN_COUNT, 0);
+			std::vector<std::shared_ptr<TaskEvent>> gates;
+			std::vector<std::shared_ptr<TaskEvent>> tails;
+
+			// Chains are held back until fully built so only their execution is measured
+			for (int32_t chain = 0; chain < CHAIN_COUNT; ++chain)
+			{
+				std::shared_ptr<TaskEvent> previous = gates.emplace_back(std::make_shared<TaskEvent>());
+				uint64_t* value = &values[chain];
+				for (int32_t i = 0; i < CHAIN_LENGTH; ++i)
+				{
+					previous = JobTask::CreateAndDispatch([value]() { *value = *value * 31 + 7; }, { previous }, params);
+				}
+				tails.push_back(previous);
+			}
+
+			ScopedTimer timer;
+			for (std::shared_ptr<TaskEvent>& gate : gates)
+			{
+				gate->Complete();
+			}
+			TaskEvent::WaitAll(tails);
+			return timer.GetElapsedMs();
+		}
+	}
+
+	void Benchmark_TaskChain()
+	{
+		JobSystem::Initialize();
+
+		std::cout << "  " << CHAIN_COUNT << " chains of " << CHAIN_LENGTH << " tasks\n";
+
+		double queuedMs = RunChains(ETaskFlags::NoInline);
+		PrintResult("Queued continuations", queuedMs * 1000000.0 / (CHAIN_LENGTH * CHAIN_COUNT), "ns/link");
+
+		double inlineMs = RunChains(ETaskFlags::None);
+		PrintResult("Inlined continuations", inlineMs * 1000000.0 / (CHAIN_LENGTH * CHAIN_COUNT), "ns/link");
+
+		JobSystem::Shutdown();
+	}
+}
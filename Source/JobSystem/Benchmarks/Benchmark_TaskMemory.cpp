@@ -0,0 +1,76 @@
+// Task bodies building temporary buffers, std::vector on the heap against the worker scratch allocator
+
+#include "Benchmarks.h"
+#include "Jobs/JobSystem.h"
+#include "Jobs/TaskGroup.h"
+#include "Jobs/TaskMemory.h"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+namespace SV::Benchmarks
+{
+	namespace
+	{
+		constexpr int32_t TASK_COUNT = 100000;
+		constexpr int32_t BUFFERS_PER_TASK = 4;
+		constexpr int32_t BUFFER_SIZE = 256;
+		constexpr int32_t REPEAT_COUNT = 3;
+
+		template<typename TMakeBuffer>
+		void FillBuffers(std::atomic<int64_t>& checksum, TMakeBuffer&& makeBuffer)
+		{
+			int64_t sum = 0;
+			for (int32_t i = 0; i < BUFFERS_PER_TASK; ++i)
+			{
+				auto buffer = makeBuffer();
+				for (int32_t j = 0; j < BUFFER_SIZE; ++j)
+				{
+					buffer.push_back(i + j);
+				}
+				sum += buffer.back();
+			}
+			checksum.fetch_add(sum, std::memory_order_relaxed);
+		}
+
+		template<typename TBody>
+		double MeasureTasks(TBody&& body)
+		{
+			double bestMs = 0.0;
+			for (int32_t i = 0; i < REPEAT_COUNT; ++i)
+			{
+				ScopedTimer timer;
+				TaskGroup group(ETaskSpawnMode::Queued);
+				for (int32_t task = 0; task < TASK_COUNT; ++task)
+				{
+					group.Spawn(body);
+				}
+				group.Wait();
+				const double elapsedMs = timer.GetElapsedMs();
+				bestMs = i == 0 ? elapsedMs : std::min(bestMs, elapsedMs);
+			}
+			return bestMs;
+		}
+	}
+
+	void Benchmark_TaskMemory()
+	{
+		JobSystem::Initialize();
+		std::cout << "  " << TASK_COUNT << " tasks, " << BUFFERS_PER_TASK << " growing buffers of " << BUFFER_SIZE << " ints each\n";
+
+		std::atomic<int64_t> checksum{ 0 };
+		PrintResult("std::vector", MeasureTasks([&checksum]()
+			{
+				FillBuffers(checksum, []() { return std::vector<int32_t>(); });
+			}), "ms");
+		PrintResult("ScratchVector", MeasureTasks([&checksum]()
+			{
+				FillBuffers(checksum, []() { return MakeScratchVector<int32_t>(); });
+			}), "ms");
+
+		const JobSystemStats stats = JobSystem::Get().GetStats();
+		std::cout << "  scratch high-water mark " << stats.ScratchHighWaterMark << " bytes\n";
+		JobSystem::Shutdown();
+	}
+}
@@ -0,0 +1,229 @@
+// Task synchronization primitives against their std counterparts with more waiting tasks than workers
+
+#include "Benchmarks.h"
+#include "Jobs/JobSystem.h"
+#include "Jobs/TaskSynchronization.h"
+
+#include <algorithm>
+#include <barrier>
+#include <functional>
+#include <latch>
+#include <mutex>
+#include <semaphore>
+#include <thread>
+#include <vector>
+
+namespace SV::Benchmarks
+{
+	namespace
+	{
+		constexpr int32_t TASKS_PER_WORKER = 8;
+		constexpr int32_t LOCKS_PER_TASK = 2000;
+		constexpr int32_t SEMAPHORE_TASK_WORK = 20000;
+		constexpr int32_t FREE_TASK_WORK = 5000;
+		constexpr int32_t BARRIER_PHASES = 200;
+		constexpr int32_t LATCH_ROUNDS = 500;
+
+		uint64_t BusyWork(int32_t iterations)
+		{
+			volatile uint64_t value = 0;
+			for (int32_t i = 0; i < iterations; ++i)
+			{
+				value = value + static_cast<uint64_t>(i);
+			}
+			return value;
+		}
+
+		int32_t GetWorkerCount()
+		{
+			return std::max(1, JobSystem::Get().GetWorkerCount(EWorkerGroup::Foreground));
+		}
+
+		double RunTasks(int32_t taskCount, const std::function<void()>& body)
+		{
+			ScopedTimer timer;
+			std::vector<std::shared_ptr<TaskEvent>> events;
+			events.reserve(taskCount);
+			for (int32_t i = 0; i < taskCount; ++i)
+			{
+				events.push_back(JobTask::CreateAndDispatch([&body]() { body(); }));
+			}
+			TaskEvent::WaitAll(events);
+			return timer.GetElapsedMs();
+		}
+
+		template<typename TLock, typename TLockFunction, typename TUnlockFunction>
+		double RunMutex(TLock& lock, TLockFunction&& lockFunction, TUnlockFunction&& unlockFunction)
+		{
+			uint64_t shared = 0;
+			return RunTasks(GetWorkerCount() * TASKS_PER_WORKER, [&]()
+				{
+					for (int32_t i = 0; i < LOCKS_PER_TASK; ++i)
+					{
+						lockFunction(lock);
+						shared += BusyWork(10);
+						unlockFunction(lock);
+						BusyWork(100);
+					}
+				});
+		}
+
+		// Half the tasks contend for a few units, the other half is free to run. Blocked workers can't run the free ones
+		template<typename TLimitedBody>
+		double RunSemaphore(TLimitedBody&& limitedBody)
+		{
+			const int32_t taskCount = GetWorkerCount() * TASKS_PER_WORKER;
+			ScopedTimer timer;
+			std::vector<std::shared_ptr<TaskEvent>> events;
+			for (int32_t i = 0; i < taskCount; ++i)
+			{
+				events.push_back(limitedBody());
+				events.push_back(JobTask::CreateAndDispatch([]() { BusyWork(FREE_TASK_WORK); }));
+			}
+			TaskEvent::WaitAll(events);
+			return timer.GetElapsedMs();
+		}
+
+		void BenchmarkMutex()
+		{
+			std::mutex stdMutex;
+			TaskMutex taskMutex;
+			PrintResult("std::mutex", RunMutex(stdMutex, [](std::mutex& m) { m.lock(); }, [](std::mutex& m) { m.unlock(); }), "ms");
+			PrintResult("TaskMutex", RunMutex(taskMutex, [](TaskMutex& m) { m.Lock(); }, [](TaskMutex& m) { m.Unlock(); }), "ms");
+		}
+
+		void BenchmarkSemaphore()
+		{
+			const int32_t unitCount = std::max(1, GetWorkerCount() / 2);
+			std::counting_semaphore<> stdSemaphore(unitCount);
+			TaskSemaphore taskSemaphore(unitCount);
+
+			PrintResult("std::counting_semaphore", RunSemaphore([&]()
+				{
+					return JobTask::CreateAndDispatch([&]()
+						{
+							stdSemaphore.acquire();
+							BusyWork(SEMAPHORE_TASK_WORK);
+							stdSemaphore.release();
+						});
+				}), "ms");
+			PrintResult("TaskSemaphore::Acquire", RunSemaphore([&]()
+				{
+					return JobTask::CreateAndDispatch([&]()
+						{
+							taskSemaphore.Acquire();
+							BusyWork(SEMAPHORE_TASK_WORK);
+							taskSemaphore.Release();
+						});
+				}), "ms");
+			PrintResult("TaskSemaphore::Launch", RunSemaphore([&]()
+				{
+					return taskSemaphore.Launch([]() { BusyWork(SEMAPHORE_TASK_WORK); });
+				}), "ms");
+		}
+
+		// std::barrier needs a thread per participant, the task barrier continues each participant as a dependent task
+		void BenchmarkBarrier()
+		{
+			const int32_t participantCount = GetWorkerCount() * TASKS_PER_WORKER;
+			{
+				std::barrier<> barrier(participantCount);
+				std::vector<std::thread> threads;
+				ScopedTimer timer;
+				for (int32_t i = 0; i < participantCount; ++i)
+				{
+					threads.emplace_back([&barrier]()
+						{
+							for (int32_t phase = 0; phase < BARRIER_PHASES; ++phase)
+							{
+								BusyWork(FREE_TASK_WORK);
+								barrier.arrive_and_wait();
+							}
+						});
+				}
+				for (std::thread& thread : threads)
+				{
+					thread.join();
+				}
+				PrintResult("std::barrier, thread per participant", timer.GetElapsedMs(), "ms");
+			}
+			{
+				TaskBarrier barrier(participantCount);
+				TaskLatch done(participantCount);
+				std::function<void(int32_t)> runPhase = [&](int32_t phase)
+					{
+						BusyWork(FREE_TASK_WORK);
+						if (phase + 1 == BARRIER_PHASES)
+						{
+							done.CountDown();
+							return;
+						}
+						JobTask::CreateAndDispatch([&runPhase, phase]() { runPhase(phase + 1); }, barrier.Arrive());
+					};
+				ScopedTimer timer;
+				for (int32_t i = 0; i < participantCount; ++i)
+				{
+					JobTask::CreateAndDispatch([&runPhase]() { runPhase(0); });
+				}
+				done.Wait();
+				PrintResult("TaskBarrier::Arrive, task per phase", timer.GetElapsedMs(), "ms");
+			}
+		}
+
+		// Fan-in where the waiter is itself a task. std::latch blocks its worker, without a blocking region to
+		// bring in a spare the counting tasks could be stuck behind it
+		template<typename TMakeLatch>
+		double RunLatch(TMakeLatch&& makeLatch)
+		{
+			const int32_t taskCount = GetWorkerCount() * TASKS_PER_WORKER;
+			ScopedTimer timer;
+			for (int32_t round = 0; round < LATCH_ROUNDS; ++round)
+			{
+				makeLatch(taskCount)->Wait();
+			}
+			return timer.GetElapsedMs();
+		}
+
+		void BenchmarkLatch()
+		{
+			PrintResult("std::latch, blocking region", RunLatch([](int32_t taskCount)
+				{
+					return JobTask::CreateAndDispatch([taskCount]()
+						{
+							std::latch latch(taskCount);
+							for (int32_t i = 0; i < taskCount; ++i)
+							{
+								JobTask::CreateAndDispatch([&latch]() { BusyWork(FREE_TASK_WORK); latch.count_down(); });
+							}
+							ScopedBlockingRegion blockingRegion;
+							latch.wait();
+						});
+				}), "ms");
+			PrintResult("TaskLatch", RunLatch([](int32_t taskCount)
+				{
+					return JobTask::CreateAndDispatch([taskCount]()
+						{
+							TaskLatch latch(taskCount);
+							for (int32_t i = 0; i < taskCount; ++i)
+							{
+								JobTask::CreateAndDispatch([&latch]() { BusyWork(FREE_TASK_WORK); latch.CountDown(); });
+							}
+							latch.Wait();
+						});
+				}), "ms");
+		}
+	}
+
+	void Benchmark_TaskSync()
+	{
+		JobSystem::Initialize();
+		std::cout << "  " << GetWorkerCount() << " workers, " << TASKS_PER_WORKER << " waiting tasks per worker\n";
+
+		BenchmarkMutex();
+		BenchmarkSemaphore();
+		BenchmarkBarrier();
+		BenchmarkLatch();
+
+		JobSystem::Shutdown();
+	}
+}
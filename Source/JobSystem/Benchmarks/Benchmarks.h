@@ -0,0 +1,45 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+namespace SV::Benchmarks
+{
+	void Benchmark_AsyncIO();
+	void Benchmark_Affinity();
+	void Benchmark_TaskChain();
+	void Benchmark_ParallelForChunks();
+	void Benchmark_Locks();
+	void Benchmark_TaskSync();
+	void Benchmark_ForkJoin();
+	void Benchmark_Backpressure();
+	void Benchmark_FanIn();
+	void Benchmark_TaskMemory();
+	void Benchmark_Pipeline();
+	void Benchmark_LabelStats();
+
+	class ScopedTimer
+	{
+	public:
+		ScopedTimer() : m_Start(std::chrono::steady_clock::now()) {}
+
+		double GetElapsedMs() const
+		{
+			return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_Start).count();
+		}
+
+	private:
+		std::chrono::steady_clock::time_point m_Start;
+	};
+
+	inline void PrintResult(const std::string& name, double value, const char* unit)
+	{
+		std::cout << "  " << name;
+		for (size_t i = name.size(); i < 40; ++i)
+		{
+			std::cout << ' ';
+		}
+		std::cout << value << " " << unit << "\n";
+	}
+}
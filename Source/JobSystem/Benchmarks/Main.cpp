@@ -0,0 +1,50 @@
+// Benchmarks, run all or the ones named on the command line
+
+#include "Benchmarks.h"
+
+#include <cstring>
+#include <iostream>
+
+using namespace SV::Benchmarks;
+
+struct BenchmarkEntry
+{
+	const char* Name;
+	void (*Function)();
+};
+
+static const BenchmarkEntry s_Benchmarks[] =
+{
+	{ "AsyncIO", Benchmark_AsyncIO },
+	{ "TaskChain", Benchmark_TaskChain },
+	{ "Affinity", Benchmark_Affinity },
+	{ "ParallelForChunks", Benchmark_ParallelForChunks },
+	{ "Locks", Benchmark_Locks },
+	{ "TaskSync", Benchmark_TaskSync },
+	{ "ForkJoin", Benchmark_ForkJoin },
+	{ "Backpressure", Benchmark_Backpressure },
+	{ "FanIn", Benchmark_FanIn },
+	{ "TaskMemory", Benchmark_TaskMemory },
+	{ "Pipeline", Benchmark_Pipeline },
+	{ "LabelStats", Benchmark_LabelStats },
+};
+
+int main(int argc, char** argv)
+{
+	for (const BenchmarkEntry& benchmark : s_Benchmarks)
+	{
+		bool bSelected = argc < 2;
+		for (int i = 1; i < argc; ++i)
+		{
+			bSelected |= std::strcmp(argv[i], benchmark.Name) == 0;
+		}
+		if (!bSelected)
+		{
+			continue;
+		}
+
+		std::cout << "\n=== Benchmark: " << benchmark.Name << " ===\n";
+		benchmark.Function();
+	}
+	return 0;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace SV
+{
+	// Covers a cache line and the widest SIMD register we use (AVX-512)
+	constexpr size_t CACHE_LINE_ALIGNMENT = 64;
+
+	// Allocator for SoA component streams, chunks handed out by ParallelForChunks start on a cache line
+	template<typename T, size_t Alignment = CACHE_LINE_ALIGNMENT>
+	class AlignedAllocator
+	{
+	public:
+		using value_type = T;
+
+		template<typename U>
+		struct rebind
+		{
+			using other = AlignedAllocator<U, Alignment>;
+		};
+
+		AlignedAllocator() = default;
+		template<typename U>
+		AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+		T* allocate(size_t count)
+		{
+			return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(Alignment)));
+		}
+
+		void deallocate(T* pointer, size_t)
+		{
+			::operator delete(pointer, std::align_val_t(Alignment));
+		}
+
+		template<typename U>
+		bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+	};
+
+	template<typename T>
+	using AlignedArray = std::vector<T, AlignedAllocator<T>>;
+}
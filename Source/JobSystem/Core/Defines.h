@@ -21,7 +21,12 @@ private: \
 
 
 #define ENUM_CLASS_FLAGS(Enum) \
-	inline constexpr Enum& operator~ (Enum e) {return (Enum)~(std::underlying_type_t(Enum))e; }
+	inline constexpr Enum& operator|=(Enum& lhs, Enum rhs) { return lhs = (Enum)((std::underlying_type_t<Enum>)lhs | (std::underlying_type_t<Enum>)rhs); } \
+	inline constexpr Enum& operator&=(Enum& lhs, Enum rhs) { return lhs = (Enum)((std::underlying_type_t<Enum>)lhs & (std::underlying_type_t<Enum>)rhs); } \
+	inline constexpr Enum operator|(Enum lhs, Enum rhs) { return (Enum)((std::underlying_type_t<Enum>)lhs | (std::underlying_type_t<Enum>)rhs); } \
+	inline constexpr Enum operator&(Enum lhs, Enum rhs) { return (Enum)((std::underlying_type_t<Enum>)lhs & (std::underlying_type_t<Enum>)rhs); } \
+	inline constexpr Enum operator~(Enum e) { return (Enum)~(std::underlying_type_t<Enum>)e; } \
+	inline constexpr bool operator!(Enum e) { return !(std::underlying_type_t<Enum>)e; }
 
 
 
@@ -30,6 +35,13 @@ private: \
 template<typename Enum>
 constexpr bool EnumHasAnyFlags(Enum flagsSet, Enum flagsSubset)
 {
-	using UnderlyingType = std::underlying_type_t(Enum);
-	return ((UnderlyingType)flagsSet & (UnderlyingType)flagsSubset) == (UnderlyingType)flagsSubset;
+	using UnderlyingType = std::underlying_type_t<Enum>;
+	return ((UnderlyingType)flagsSet & (UnderlyingType)flagsSubset) != 0;
 }
+
+template<typename Enum>
+constexpr bool EnumHasAllFlags(Enum flagsSet, Enum flagsSubset)
+{
+	using UnderlyingType = std::underlying_type_t<Enum>;
+	return ((UnderlyingType)flagsSet & (UnderlyingType)flagsSubset) == (UnderlyingType)flagsSubset;
+}
\ No newline at end of file
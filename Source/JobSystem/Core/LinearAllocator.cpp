@@ -0,0 +1,144 @@
+#include "LinearAllocator.h"
+#include "Core/AlignedAllocator.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+#if defined(__SANITIZE_ADDRESS__)
+#define SV_ASAN 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define SV_ASAN 1
+#endif
+#endif
+
+#if defined(SV_ASAN)
+#include <sanitizer/asan_interface.h>
+#define SV_POISON_MEMORY(address, size) ASAN_POISON_MEMORY_REGION(address, size)
+#define SV_UNPOISON_MEMORY(address, size) ASAN_UNPOISON_MEMORY_REGION(address, size)
+#else
+#define SV_POISON_MEMORY(address, size) ((void)(address), (void)(size))
+#define SV_UNPOISON_MEMORY(address, size) ((void)(address), (void)(size))
+#endif
+
+namespace SV
+{
+	namespace
+	{
+		constexpr std::byte FREED_PATTERN{ 0xDD };
+
+		void ReleaseRange(std::byte* begin, size_t size)
+		{
+#ifndef NDEBUG
+			// Padding and skipped blocks in the range are poisoned already
+			SV_UNPOISON_MEMORY(begin, size);
+			std::memset(begin, static_cast<int>(FREED_PATTERN), size);
+#endif
+			SV_POISON_MEMORY(begin, size);
+		}
+
+		size_t AlignOffset(const std::byte* base, size_t offset, size_t alignment)
+		{
+			const uintptr_t address = reinterpret_cast<uintptr_t>(base) + offset;
+			return offset + ((alignment - address % alignment) % alignment);
+		}
+	}
+
+	LinearAllocator::LinearAllocator(size_t blockSize /*= DEFAULT_BLOCK_SIZE*/)
+		: m_BlockSize(std::max<size_t>(blockSize, CACHE_LINE_ALIGNMENT))
+	{
+	}
+
+	LinearAllocator::~LinearAllocator()
+	{
+		for (Block& block : m_Blocks)
+		{
+			SV_UNPOISON_MEMORY(block.Memory, block.Size);
+			::operator delete(block.Memory, std::align_val_t(CACHE_LINE_ALIGNMENT));
+		}
+	}
+
+	void* LinearAllocator::Allocate(size_t size, size_t alignment /*= alignof(std::max_align_t)*/)
+	{
+		assert(alignment > 0 && (alignment & (alignment - 1)) == 0 && "Alignment must be a power of two");
+		if (m_BlockIndex < m_Blocks.size())
+		{
+			Block& block = m_Blocks[m_BlockIndex];
+			const size_t begin = AlignOffset(block.Memory, m_Offset, alignment);
+			if (begin + size <= block.Size)
+			{
+				m_Offset = begin + size;
+				SV_UNPOISON_MEMORY(block.Memory + begin, size);
+				UpdateHighWaterMark();
+				return block.Memory + begin;
+			}
+		}
+		return AllocateFromNextBlock(size, alignment);
+	}
+
+	void* LinearAllocator::AllocateFromNextBlock(size_t size, size_t alignment)
+	{
+		// Kept blocks too small for this allocation are skipped until the next rewind
+		const size_t requiredSize = size + (alignment > CACHE_LINE_ALIGNMENT ? alignment : 0);
+		size_t index = m_Blocks.empty() ? 0 : m_BlockIndex + 1;
+		while (index < m_Blocks.size() && m_Blocks[index].Size < requiredSize)
+		{
+			++index;
+		}
+		if (index == m_Blocks.size())
+		{
+			const size_t blockSize = std::max(m_BlockSize, requiredSize);
+			std::byte* memory = static_cast<std::byte*>(::operator new(blockSize, std::align_val_t(CACHE_LINE_ALIGNMENT)));
+			const size_t startBytes = m_Blocks.empty() ? 0 : m_Blocks.back().StartBytes + m_Blocks.back().Size;
+			m_Blocks.push_back({ memory, blockSize, startBytes });
+			ReleaseRange(memory, blockSize);
+		}
+
+		Block& block = m_Blocks[index];
+		const size_t begin = AlignOffset(block.Memory, 0, alignment);
+		m_BlockIndex = index;
+		m_Offset = begin + size;
+		SV_UNPOISON_MEMORY(block.Memory + begin, size);
+		UpdateHighWaterMark();
+		return block.Memory + begin;
+	}
+
+	void LinearAllocator::RewindTo(const Marker& marker)
+	{
+		assert((marker.BlockIndex < m_BlockIndex || (marker.BlockIndex == m_BlockIndex && marker.Offset <= m_Offset))
+			&& "Rewinding past the current position, markers must be released in reverse order");
+		for (size_t index = marker.BlockIndex; index <= m_BlockIndex && index < m_Blocks.size(); ++index)
+		{
+			const size_t begin = index == marker.BlockIndex ? marker.Offset : 0;
+			const size_t end = index == m_BlockIndex ? m_Offset : m_Blocks[index].Size;
+			if (end > begin)
+			{
+				ReleaseRange(m_Blocks[index].Memory + begin, end - begin);
+			}
+		}
+		m_BlockIndex = marker.BlockIndex;
+		m_Offset = marker.Offset;
+	}
+
+	size_t LinearAllocator::GetUsedBytes() const
+	{
+		return m_BlockIndex < m_Blocks.size() ? m_Blocks[m_BlockIndex].StartBytes + m_Offset : 0;
+	}
+
+	size_t LinearAllocator::GetReservedBytes() const
+	{
+		return m_Blocks.empty() ? 0 : m_Blocks.back().StartBytes + m_Blocks.back().Size;
+	}
+
+	void LinearAllocator::UpdateHighWaterMark()
+	{
+		const size_t usedBytes = GetUsedBytes();
+		if (usedBytes > m_HighWaterMark.load(std::memory_order_relaxed))
+		{
+			m_HighWaterMark.store(usedBytes, std::memory_order_relaxed);
+		}
+	}
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include "Core/Defines.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace SV
+{
+	// Bump allocator over a list of blocks, freed all at once by rewinding to a marker or resetting. Blocks are kept
+	// for reuse, an allocation that doesn't fit moves on to the next block or adds one. Single threaded, only the
+	// high-water mark may be read from other threads.
+	// Debug builds fill rewound memory with a pattern and poison it under ASAN, so pointers escaping their scope
+	// show up on the next access
+	class LinearAllocator
+	{
+		NONCOPYABLE_NONMOVABLE(LinearAllocator);
+	public:
+		static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+		struct Marker
+		{
+			size_t BlockIndex = 0;
+			size_t Offset = 0;
+		};
+
+		explicit LinearAllocator(size_t blockSize = DEFAULT_BLOCK_SIZE);
+		~LinearAllocator();
+
+		void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+		// Elements are default initialized, nothing is destroyed on rewind
+		template<typename T>
+		T* Allocate(size_t count = 1)
+		{
+			static_assert(std::is_trivially_destructible_v<T>, "LinearAllocator never runs destructors");
+			T* elements = static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+			std::uninitialized_default_construct_n(elements, count);
+			return elements;
+		}
+
+		Marker GetMarker() const { return { m_BlockIndex, m_Offset }; }
+		// Frees everything allocated since the marker was taken
+		void RewindTo(const Marker& marker);
+		void Reset() { RewindTo(Marker()); }
+
+		size_t GetUsedBytes() const;
+		size_t GetReservedBytes() const;
+		size_t GetHighWaterMark() const { return m_HighWaterMark.load(std::memory_order_relaxed); }
+
+	private:
+		struct Block
+		{
+			std::byte* Memory;
+			size_t Size;
+			size_t StartBytes; // Sizes of the blocks before this one
+		};
+
+		void* AllocateFromNextBlock(size_t size, size_t alignment);
+		void UpdateHighWaterMark();
+
+	private:
+		const size_t m_BlockSize;
+		std::vector<Block> m_Blocks;
+		size_t m_BlockIndex = 0;
+		size_t m_Offset = 0;
+		std::atomic<size_t> m_HighWaterMark{ 0 };
+	};
+
+	// Standard allocator over a LinearAllocator, deallocation is a no-op
+	template<typename T>
+	class LinearStlAllocator
+	{
+	public:
+		using value_type = T;
+
+		explicit LinearStlAllocator(LinearAllocator& allocator) : m_Allocator(&allocator) {}
+		template<typename U>
+		LinearStlAllocator(const LinearStlAllocator<U>& other) : m_Allocator(other.GetAllocator()) {}
+
+		T* allocate(size_t count)
+		{
+			return static_cast<T*>(m_Allocator->Allocate(sizeof(T) * count, alignof(T)));
+		}
+
+		void deallocate(T*, size_t) {}
+
+		LinearAllocator* GetAllocator() const { return m_Allocator; }
+
+		template<typename U>
+		bool operator==(const LinearStlAllocator<U>& other) const { return m_Allocator == other.GetAllocator(); }
+
+	private:
+		LinearAllocator* m_Allocator;
+	};
+}
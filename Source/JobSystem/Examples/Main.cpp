@@ -1,12 +1,22 @@
 // main.cpp
 
 #include "Jobs/JobSystem.h"
+#include "Jobs/TaskPipe.h"
+#include "Jobs/ResourceScheduler.h"
+#include "Jobs/ParallelFor.h"
+#include "Jobs/TaskSynchronization.h"
+#include "Jobs/TaskGroup.h"
+#include "Jobs/Pipeline.h"
 #include "Platform/Platform.h"
 
 #include <iostream>
 #include <chrono>
 #include <thread>
 #include <vector>
+#include <algorithm>
+#include <bit>
+#include <numeric>
+#include <filesystem>
 
 using namespace SV;
 
@@ -185,6 +195,611 @@ void Example_ParallelProcessing()
 	std::cout << "Parallel processing completed\n";
 }
 
+void Example_TaskPipe()
+{
+	std::cout << "\n=== Example 6: Task Pipe ===\n";
+
+	// Not thread-safe, every access goes through the pipe
+	std::vector<int32_t> mixerState;
+	TaskPipe mixerPipe("AudioMixer");
+
+	std::shared_ptr<TaskEvent> lastTask;
+	for (int32_t i = 0; i < 8; ++i)
+	{
+		lastTask = mixerPipe.Launch(
+			[i, &mixerState]()
+			{
+				mixerState.push_back(i);
+			});
+	}
+
+	lastTask->Wait();
+	mixerPipe.WaitUntilEmpty();
+
+	std::cout << "Mixer state:";
+	for (int32_t value : mixerState)
+	{
+		std::cout << " " << value;
+	}
+	std::cout << "\nTask pipe completed\n";
+}
+void Example_ResourceScheduler()
+{
+	std::cout << "\n=== Example 7: Resource Access Scheduling ===\n";
+
+	ResourceScheduler scheduler;
+	std::vector<int32_t> positions(4, 0);
+	std::vector<int32_t> velocities(4, 1);
+	ResourceId positionsId = MakeResourceId(&positions);
+	ResourceId velocitiesId = MakeResourceId(&velocities);
+
+	// Integrate waits for nothing, both readers run concurrently after it
+	scheduler.Dispatch(
+		[&]()
+		{
+			for (size_t i = 0; i < positions.size(); ++i)
+			{
+				positions[i] += velocities[i];
+			}
+		}, { ResourceAccess::Write(positionsId), ResourceAccess::Read(velocitiesId) });
+
+	std::shared_ptr<TaskEvent> renderTask = scheduler.Dispatch(
+		[&]()
+		{
+			std::cout << "Render reads position " << positions[0] << "\n";
+		}, { ResourceAccess::Read(positionsId) });
+	std::shared_ptr<TaskEvent> audioTask = scheduler.Dispatch(
+		[&]()
+		{
+			std::cout << "Audio reads position " << positions[1] << "\n";
+		}, { ResourceAccess::Read(positionsId) });
+
+	// Waits for both readers
+	std::shared_ptr<TaskEvent> resetTask = scheduler.Dispatch(
+		[&]()
+		{
+			std::fill(positions.begin(), positions.end(), 0);
+			std::cout << "Positions reset\n";
+		}, { ResourceAccess::Write(positionsId) });
+
+	resetTask->Wait();
+	std::cout << "Resource access scheduling completed\n";
+}
+void Example_Timers()
+{
+	std::cout << "\n=== Example 8: Delayed and Periodic Tasks ===\n";
+
+	std::atomic<int32_t> pollCount{ 0 };
+	TimerHandle streamingPoll = JobTask::DispatchEvery(std::chrono::milliseconds(10),
+		[&pollCount]()
+		{
+			pollCount.fetch_add(1, std::memory_order_relaxed);
+		});
+
+	auto dispatchTime = std::chrono::steady_clock::now();
+	std::shared_ptr<TaskEvent> delayedTask = JobTask::DispatchAfter(std::chrono::milliseconds(16),
+		[dispatchTime]()
+		{
+			auto delay = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - dispatchTime);
+			std::cout << "Delayed task ran after " << delay.count() << "us\n";
+		});
+
+	delayedTask->Wait();
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	streamingPoll.Cancel();
+
+	std::cout << "Streaming polled " << pollCount.load() << " times\n";
+	std::cout << "Timer tasks completed\n";
+}
+void Example_WorkerGroups()
+{
+	std::cout << "\n=== Example 9: Worker Groups ===\n";
+
+	TaskParams backgroundParams;
+	backgroundParams.Group = EWorkerGroup::Background;
+	std::shared_ptr<TaskEvent> shaderCompile = JobTask::CreateAndDispatch(
+		[]()
+		{
+			std::cout << "Compiling shaders in background...\n";
+			std::this_thread::sleep_for(std::chrono::milliseconds(100));
+			std::cout << "Shaders compiled\n";
+		}, {}, backgroundParams);
+
+	std::shared_ptr<TaskEvent> frameTask = JobTask::CreateAndDispatch(
+		[]()
+		{
+			std::cout << "Frame task runs on a foreground worker\n";
+		});
+
+	frameTask->Wait();
+	shaderCompile->Wait();
+	std::cout << "Worker groups completed\n";
+}
+
+void Example_BlockingTasks()
+{
+	std::cout << "\n=== Example 10: Blocking Tasks ===\n";
+
+	// Blocking tasks hand their core to a spare worker while they wait
+	TaskParams blockingParams;
+	blockingParams.Flags = ETaskFlags::Blocking;
+	std::shared_ptr<TaskEvent> networkWait = JobTask::CreateAndDispatch(
+		[]()
+		{
+			std::cout << "Waiting on network reply...\n";
+			std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		}, {}, blockingParams);
+
+	std::vector<std::shared_ptr<TaskEvent>> events;
+	for (int32_t i = 0; i < 8; i++)
+	{
+		events.push_back(JobTask::CreateAndDispatch([]() {}));
+	}
+	TaskEvent::WaitAll(events);
+	std::cout << "Frame work finished while blocked\n";
+
+	networkWait->Wait();
+	JobSystemStats stats = JobSystem::Get().GetStats(EWorkerGroup::Foreground);
+	std::cout << "Peak active spare workers: " << stats.PeakActiveSpareWorkerCount << "\n";
+}
+
+void Example_WorkerScaling()
+{
+	std::cout << "\n=== Example 11: Worker Scaling ===\n";
+
+	JobSystem& jobSystem = JobSystem::Get();
+	const int32_t workerCount = jobSystem.GetWorkerCount(EWorkerGroup::Foreground);
+
+	// Idle workers park after a short while and are woken again as tasks queue up
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	std::cout << "Active workers after idling: " << jobSystem.GetActiveWorkerCount(EWorkerGroup::Foreground) << "/" << workerCount << "\n";
+
+	// Manual override, e.g. to leave cores to another process
+	jobSystem.SetActiveWorkerCount(EWorkerGroup::Foreground, 1);
+	std::vector<std::shared_ptr<TaskEvent>> events;
+	for (int32_t i = 0; i < 64; i++)
+	{
+		events.push_back(JobTask::CreateAndDispatch([]() {}));
+	}
+	TaskEvent::WaitAll(events);
+	std::cout << "Ran 64 tasks on " << jobSystem.GetActiveWorkerCount(EWorkerGroup::Foreground) << " active worker\n";
+
+	jobSystem.SetActiveWorkerBounds(EWorkerGroup::Foreground, 1, workerCount);
+}
+
+void Example_FrameDeadlines()
+{
+	std::cout << "\n=== Example 12: Frame Deadlines ===\n";
+
+	JobSystem& jobSystem = JobSystem::Get();
+	jobSystem.ConsumeDeadlineStats();
+
+	const auto frameStart = std::chrono::steady_clock::now();
+	const auto vsync = frameStart + std::chrono::microseconds(16600);
+
+	// Work with slack, no deadline
+	std::vector<std::shared_ptr<TaskEvent>> events;
+	for (int32_t i = 0; i < 4; i++)
+	{
+		events.push_back(JobTask::CreateAndDispatch([]()
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(2));
+			}));
+	}
+
+	// Late frame work overtakes queued tasks without deadlines at the next task boundary
+	TaskParams renderParams;
+	renderParams.Deadline = vsync - std::chrono::milliseconds(4);
+	events.push_back(JobTask::CreateAndDispatch([]() { std::cout << "Building render commands\n"; }, {}, renderParams));
+
+	TaskParams presentParams;
+	presentParams.Deadline = vsync;
+	events.push_back(JobTask::CreateAndDispatch([]() { std::cout << "Presenting frame\n"; }, {}, presentParams));
+
+	TaskEvent::WaitAll(events);
+
+	DeadlineStats stats = jobSystem.ConsumeDeadlineStats();
+	std::cout << "Deadline tasks: " << stats.CompletedCount << ", missed: " << stats.MissCount << "\n";
+}
+
+void Example_GraphCapture()
+{
+	std::cout << "\n=== Example 13: Task Graph Capture ===\n";
+
+	TaskGraphRecorder& recorder = JobSystem::Get().GetGraphRecorder();
+	recorder.Begin();
+
+	auto work = [](int32_t microseconds)
+		{
+			return [microseconds]() { std::this_thread::sleep_for(std::chrono::microseconds(microseconds)); };
+		};
+	auto launch = [](const char* label, JobTask::TaskFunction&& function, const std::vector<std::shared_ptr<TaskEvent>>& prerequisites)
+		{
+			TaskParams params;
+			params.Label = label;
+			return JobTask::CreateAndDispatch(std::move(function), prerequisites, params);
+		};
+
+	// Short fan-out next to a long chain, the chain sets the frame time
+	auto input = launch("Input", work(100), {});
+	std::vector<std::shared_ptr<TaskEvent>> particles;
+	for (int32_t i = 0; i < 4; i++)
+	{
+		particles.push_back(launch("Particles", work(200), { input }));
+	}
+	auto animation = launch("Animation", work(1000), { input });
+	auto physics = launch("Physics", work(1500), { animation });
+	particles.push_back(physics);
+	auto render = launch("Render", work(300), particles);
+	render->Wait();
+
+	TaskGraph graph = recorder.End();
+	TaskGraphAnalysis analysis = AnalyzeTaskGraph(graph);
+	std::cout << "Captured " << graph.Nodes.size() << " tasks, average parallelism " << analysis.AverageParallelism << "\n";
+	std::cout << "Critical path:";
+	for (uint64_t id : analysis.CriticalPath)
+	{
+		std::cout << " " << graph.FindNode(id)->Label;
+	}
+	std::cout << "\nCritical path work " << analysis.CriticalPathWorkNs / 1000 << " us, delay " << analysis.CriticalPathDelayNs / 1000 << " us\n";
+
+	// Full report with the TaskGraphAnalyzer tool, the binary workload can be replayed with the WorkloadReplay tool
+	graph.Save((std::filesystem::temp_directory_path() / "JobSystemTaskGraph.tsv").string());
+	graph.SaveBinary((std::filesystem::temp_directory_path() / "JobSystemWorkload.bin").string());
+}
+
+void Example_ParallelForChunks()
+{
+	std::cout << "\n=== Example 14: Parallel For Over SoA Streams ===\n";
+
+	constexpr size_t COUNT = 100000;
+	AlignedArray<float> positions(COUNT, 0.0f);
+	AlignedArray<float> velocities(COUNT, 2.0f);
+
+	// Every chunk starts on a cache line in both streams, the loop vectorizes without a peel loop
+	ParallelForChunks(COUNT, [](float* position, const float* velocity, size_t count)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				position[i] += velocity[i] * 0.5f;
+			}
+		}, positions.data(), velocities.data());
+
+	std::cout << "Integrated " << COUNT << " positions, last: " << positions.back() << "\n";
+}
+
+void Example_TaskSynchronization()
+{
+	std::cout << "\n=== Example 16: Task Synchronization ===\n";
+
+	// Waiting workers run other queued tasks instead of blocking
+	TaskMutex mutex;
+	int32_t total = 0;
+	std::vector<std::shared_ptr<TaskEvent>> events;
+	for (int32_t i = 0; i < 16; i++)
+	{
+		events.push_back(JobTask::CreateAndDispatch([&mutex, &total, i]()
+			{
+				ScopedTaskLock lock(mutex);
+				total += i;
+			}));
+	}
+	TaskEvent::WaitAll(events);
+	std::cout << "Sum under TaskMutex: " << total << "\n";
+
+	// At most two tasks inside, the others wait in the semaphore without occupying a worker
+	TaskSemaphore semaphore(2);
+	std::atomic<int32_t> insideCount{ 0 };
+	std::atomic<int32_t> maxInsideCount{ 0 };
+	events.clear();
+	for (int32_t i = 0; i < 8; i++)
+	{
+		events.push_back(semaphore.Launch([&insideCount, &maxInsideCount]()
+			{
+				int32_t inside = ++insideCount;
+				int32_t maxInside = maxInsideCount.load();
+				while (inside > maxInside && !maxInsideCount.compare_exchange_weak(maxInside, inside))
+				{
+				}
+				std::this_thread::sleep_for(std::chrono::milliseconds(2));
+				insideCount--;
+			}));
+	}
+	TaskEvent::WaitAll(events);
+	std::cout << "Max tasks inside TaskSemaphore(2): " << maxInsideCount.load() << "\n";
+
+	// Each participant continues as a task depending on the phase event, so there can be more of them than workers
+	constexpr int32_t PARTICIPANT_COUNT = 32;
+	constexpr int32_t PHASE_COUNT = 3;
+	TaskBarrier barrier(PARTICIPANT_COUNT, []() { std::cout << "Barrier phase complete\n"; });
+	TaskLatch finished(PARTICIPANT_COUNT);
+	std::function<void(int32_t)> runPhase = [&](int32_t phase)
+		{
+			if (phase == PHASE_COUNT)
+			{
+				finished.CountDown();
+				return;
+			}
+			JobTask::CreateAndDispatch([&runPhase, phase]() { runPhase(phase + 1); }, barrier.Arrive());
+		};
+	for (int32_t i = 0; i < PARTICIPANT_COUNT; i++)
+	{
+		JobTask::CreateAndDispatch([&runPhase]() { runPhase(0); });
+	}
+	finished.Wait();
+	std::cout << PARTICIPANT_COUNT << " participants passed " << barrier.GetPhase() << " phases\n";
+}
+
+uint64_t ParallelSum(const uint32_t* values, size_t count)
+{
+	if (count <= 4096)
+	{
+		uint64_t sum = 0;
+		for (size_t i = 0; i < count; ++i)
+		{
+			sum += values[i];
+		}
+		return sum;
+	}
+	// The caller sums the upper half itself and the lower half too unless another worker stole it
+	uint64_t lower = 0;
+	uint64_t upper = 0;
+	ParallelInvoke(
+		[&]() { lower = ParallelSum(values, count / 2); },
+		[&]() { upper = ParallelSum(values + count / 2, count - count / 2); });
+	return lower + upper;
+}
+
+void Example_ParallelInvoke()
+{
+	std::cout << "\n=== Example 18: Work-First Fork-Join ===\n";
+
+	std::vector<uint32_t> values(1 << 20);
+	std::iota(values.begin(), values.end(), 0u);
+	uint64_t sum = 0;
+	JobTask::CreateAndDispatch([&]() { sum = ParallelSum(values.data(), values.size()); })->Wait();
+	std::cout << "Recursive sum: " << sum << "\n";
+
+	// Queued spawns start right away while the spawner keeps working
+	std::atomic<int32_t> loadedCount{ 0 };
+	TaskGroup group(ETaskSpawnMode::Queued);
+	for (int32_t i = 0; i < 4; i++)
+	{
+		group.Spawn([&loadedCount]() { loadedCount++; });
+	}
+	std::cout << "Spawner busy while the group runs\n";
+	group.Wait();
+	std::cout << "Group loaded " << loadedCount << " assets\n";
+}
+
+void Example_TaskMemory()
+{
+	std::cout << "\n=== Example 19: Scratch and Frame Memory ===\n";
+
+	JobSystem& jobSystem = JobSystem::Get();
+	for (int32_t frame = 0; frame < 2; frame++)
+	{
+		jobSystem.BeginFrame();
+
+		// Visible counts live in frame memory until the next frame begins, the render task reads them after culling
+		constexpr int32_t NUM_CELLS = 8;
+		int32_t* visibleCounts = TaskMemory::AllocateFrame<int32_t>(NUM_CELLS);
+		TaskGroup culling(ETaskSpawnMode::Queued);
+		for (int32_t cell = 0; cell < NUM_CELLS; cell++)
+		{
+			culling.Spawn([cell, visibleCounts]()
+				{
+					// Temporary list, freed when the task returns
+					ScratchVector<int32_t> visible = MakeScratchVector<int32_t>();
+					for (int32_t object = 0; object < 1000; object++)
+					{
+						if ((object * 7 + cell) % 3 == 0)
+						{
+							visible.push_back(object);
+						}
+					}
+					visibleCounts[cell] = static_cast<int32_t>(visible.size());
+				});
+		}
+		culling.Then([visibleCounts]()
+			{
+				int32_t total = 0;
+				for (int32_t cell = 0; cell < NUM_CELLS; cell++)
+				{
+					total += visibleCounts[cell];
+				}
+				std::cout << "Rendering " << total << " visible objects\n";
+			})->Wait();
+	}
+
+	const JobSystemStats stats = jobSystem.GetStats();
+	std::cout << "Scratch high-water mark: " << stats.ScratchHighWaterMark << " bytes\n";
+}
+
+void Example_Pipeline()
+{
+	std::cout << "\n=== Example 20: Streaming Pipeline ===\n";
+
+	struct Packet
+	{
+		int32_t Id = 0;
+		std::vector<int32_t> Payload;
+	};
+
+	// Decoding runs on several packets at once, at most 4 are in flight and the log keeps arrival order
+	int32_t nextId = 0;
+	Pipeline<Packet>(4)
+		.Input([&nextId](Packet& packet)
+			{
+				if (nextId == 6)
+				{
+					return false;
+				}
+				packet.Id = nextId++;
+				packet.Payload.assign(64, packet.Id);
+				return true;
+			})
+		.Stage(EPipelineStageMode::Parallel, [](Packet& packet)
+			{
+				for (int32_t& value : packet.Payload)
+				{
+					value *= 3;
+				}
+			})
+		.Stage(EPipelineStageMode::SerialInOrder, [](Packet& packet)
+			{
+				std::cout << "Packet " << packet.Id << " decoded, sum " << std::accumulate(packet.Payload.begin(), packet.Payload.end(), 0) << "\n";
+			})
+		.Run();
+}
+
+void Example_LabelStats()
+{
+	std::cout << "\n=== Example 21: Per-Label Task Stats ===\n";
+
+	// Earlier examples labeled tasks too, only this frame is reported
+	TaskLabelStats& labelStats = *JobSystem::Get().GetLabelStats();
+	labelStats.Reset();
+
+	auto launch = [](const char* label, int32_t microseconds)
+		{
+			TaskParams params;
+			params.Label = label;
+			return JobTask::CreateAndDispatch([microseconds]() { std::this_thread::sleep_for(std::chrono::microseconds(microseconds)); }, {}, params);
+		};
+
+	// A burst of short jobs queues up behind each other, the few long ones barely wait
+	std::vector<std::shared_ptr<TaskEvent>> events;
+	for (int32_t i = 0; i < 200; i++)
+	{
+		events.push_back(launch("Decals", 20));
+		if (i % 50 == 0)
+		{
+			events.push_back(launch("Streaming", 500));
+		}
+	}
+	for (const std::shared_ptr<TaskEvent>& event : events)
+	{
+		event->Wait();
+	}
+
+	TaskLabelStats::PrintReport(labelStats.GetReport(), std::cout);
+}
+
+void Example_TimedWaits()
+{
+	std::cout << "\n=== Example 22: Waits With Timeouts ===\n";
+
+	auto launch = [](int32_t milliseconds)
+		{
+			return JobTask::CreateAndDispatch([milliseconds]() { std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds)); });
+		};
+
+	// Short jobs fit the frame budget
+	std::vector<std::shared_ptr<TaskEvent>> culling = { launch(1), launch(2), launch(1) };
+	if (TaskEvent::WaitAllFor(culling, std::chrono::milliseconds(500)))
+	{
+		std::cout << "Culling finished within the frame budget\n";
+	}
+
+	// A slow load misses it, the frame goes on and picks the result up later
+	std::shared_ptr<TaskEvent> audio = launch(1);
+	std::shared_ptr<TaskEvent> load = launch(50);
+	if (!load->WaitFor(std::chrono::milliseconds(5)))
+	{
+		std::cout << "Load not ready after 5 ms, using the placeholder\n";
+	}
+	const std::vector<std::shared_ptr<TaskEvent>> either = { load, audio };
+	const int32_t first = TaskEvent::WaitAnyFor(either, std::chrono::milliseconds(500));
+	std::cout << "First of two finished: " << (first == 1 ? "audio" : first == 0 ? "load" : "none") << "\n";
+	load->Wait();
+	std::cout << "Load complete\n";
+}
+
+void Example_ShutdownModes()
+{
+	std::cout << "\n=== Example 15: Lazy Startup and Shutdown Modes ===\n";
+
+	// Tools that never dispatch don't pay for the worker threads
+	JobSystemConfig config = JobSystemConfig::Default();
+	config.bLazyWorkerStartup = true;
+	JobSystem::Initialize(config);
+
+	std::atomic<int32_t> ranCount{ 0 };
+	std::vector<std::shared_ptr<TaskEvent>> events;
+	for (int32_t i = 0; i < 1000; i++)
+	{
+		std::shared_ptr<TaskEvent> previous = events.empty() ? nullptr : events.back();
+		events.push_back(JobTask::CreateAndDispatch([&ranCount]()
+			{
+				std::this_thread::sleep_for(std::chrono::microseconds(100));
+				ranCount++;
+			}, previous));
+	}
+
+	// Running tasks finish, everything else in the chain is abandoned
+	std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	JobSystem::Shutdown(EShutdownMode::Cancel);
+
+	int32_t abandonedCount = 0;
+	for (const std::shared_ptr<TaskEvent>& event : events)
+	{
+		abandonedCount += event->IsAbandoned() ? 1 : 0;
+	}
+	std::cout << "Ran " << ranCount << " tasks, abandoned " << abandonedCount << ", all events complete: " << (events.back()->IsComplete() ? "yes" : "no") << "\n";
+}
+
+void Example_SchedulerInstances()
+{
+	std::cout << "\n=== Example 17: Independent Scheduler Instances ===\n";
+
+	// Two hosted simulations, each on its own half of the cores with its own queues
+	const int32_t coreCount = std::clamp(Platform::GetLogicalCoreCount(), 1, 64);
+	const int32_t firstHalf = std::max(1, coreCount / 2);
+	const uint64_t allCores = coreCount == 64 ? ~0ull : (1ull << coreCount) - 1;
+	const uint64_t firstMask = (1ull << firstHalf) - 1;
+	const uint64_t secondMask = coreCount > 1 ? allCores & ~firstMask : firstMask;
+
+	auto makeConfig = [](uint64_t affinityMask)
+		{
+			JobSystemConfig config = JobSystemConfig::Default(std::popcount(affinityMask));
+			config[EWorkerGroup::Foreground].AffinityMask = affinityMask;
+			config.FileIOBackend = EAsyncIOBackend::ThreadPool;
+			return config;
+		};
+	JobSystem physics(makeConfig(firstMask));
+	JobSystem audio(makeConfig(secondMask));
+
+	std::atomic<int32_t> physicsSteps{ 0 };
+	std::atomic<int32_t> audioSteps{ 0 };
+	auto runFrame = [](JobSystem& scheduler, std::atomic<int32_t>& steps)
+		{
+			TaskParams params;
+			params.Scheduler = &scheduler;
+			return JobTask::CreateAndDispatch([&steps]()
+				{
+					// Nested tasks stay on the instance of the worker launching them
+					std::vector<std::shared_ptr<TaskEvent>> children;
+					for (int32_t i = 0; i < 8; i++)
+					{
+						children.push_back(JobTask::CreateAndDispatch([&steps]() { steps++; }));
+					}
+					TaskEvent::WaitAll(children);
+				}, {}, params);
+		};
+
+	std::vector<std::shared_ptr<TaskEvent>> frames;
+	for (int32_t frame = 0; frame < 10; frame++)
+	{
+		frames.push_back(runFrame(physics, physicsSteps));
+		frames.push_back(runFrame(audio, audioSteps));
+	}
+	TaskEvent::WaitAll(frames);
+
+	std::cout << "Physics ran " << physicsSteps << " steps on " << physics.GetWorkerCount(EWorkerGroup::Foreground)
+		<< " workers, audio ran " << audioSteps << " steps on " << audio.GetWorkerCount(EWorkerGroup::Foreground) << " workers\n";
+	// Each instance drains and joins its workers when it goes out of scope
+}
 
 int main()
 {
@@ -193,18 +808,41 @@ int main()
 
 	JobSystem::Initialize();
 
+	// Derived from the pause cost and wake latency measured at startup, then adapted while running
+	const SpinSettings spinSettings = SpinPolicy::GetSettings();
+	std::cout << "Spin budgets: idle " << spinSettings.IdleSpinCount << ", wait " << spinSettings.WaitSpinCount
+		<< ", wake latency " << spinSettings.WakeLatency.count() / 1000 << " us\n";
+
 	Example_IndependentTasks();
 	Example_TaskChain();
 	Example_ForkJoin();
 	Example_NestedTasks();
 	Example_ParallelProcessing();
+	Example_TaskPipe();
+	Example_ResourceScheduler();
+	Example_Timers();
+	Example_WorkerGroups();
+	Example_BlockingTasks();
+	Example_WorkerScaling();
+	Example_FrameDeadlines();
+	Example_GraphCapture();
+	Example_ParallelForChunks();
+	Example_TaskSynchronization();
+	Example_ParallelInvoke();
+	Example_TaskMemory();
+	Example_Pipeline();
+	Example_LabelStats();
+	Example_TimedWaits();
 
-	std::cout << "\n=== All Examples Completed ===\n";
 	std::cout << "Waiting before shutdown...\n";
 	std::this_thread::sleep_for(std::chrono::milliseconds(500));
 
 	JobSystem::Shutdown();
 
+	Example_ShutdownModes();
+	Example_SchedulerInstances();
+
+	std::cout << "\n=== All Examples Completed ===\n";
 	std::cout << "Program finished\n";
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,265 @@
+#include "AsyncFileIO.h"
+#include "IoUringBackend.h"
+#include "Jobs/JobSystem.h"
+
+#include <thread>
+#include <cstring>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace SV
+{
+	namespace
+	{
+		intptr_t OpenForRead(const std::string& path)
+		{
+#ifdef _WIN32
+			HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			return handle == INVALID_HANDLE_VALUE ? -1 : reinterpret_cast<intptr_t>(handle);
+#else
+			return static_cast<intptr_t>(open(path.c_str(), O_RDONLY | O_CLOEXEC));
+#endif
+		}
+
+		void CloseFile(intptr_t fileHandle)
+		{
+#ifdef _WIN32
+			CloseHandle(reinterpret_cast<HANDLE>(fileHandle));
+#else
+			close(static_cast<int>(fileHandle));
+#endif
+		}
+
+		int64_t LastErrorCode()
+		{
+#ifdef _WIN32
+			return -static_cast<int64_t>(GetLastError());
+#else
+			return -static_cast<int64_t>(errno);
+#endif
+		}
+
+		// Blocking positional read until size bytes or end of file
+		int64_t ReadAt(intptr_t fileHandle, uint64_t offset, uint64_t size, uint8_t* buffer)
+		{
+			uint64_t totalRead = 0;
+			while (totalRead < size)
+			{
+#ifdef _WIN32
+				OVERLAPPED overlapped{};
+				uint64_t position = offset + totalRead;
+				overlapped.Offset = static_cast<DWORD>(position);
+				overlapped.OffsetHigh = static_cast<DWORD>(position >> 32);
+				DWORD chunk = static_cast<DWORD>(std::min<uint64_t>(size - totalRead, 1u << 30));
+				DWORD bytesRead = 0;
+				if (!ReadFile(reinterpret_cast<HANDLE>(fileHandle), buffer + totalRead, chunk, &bytesRead, &overlapped))
+				{
+					return GetLastError() == ERROR_HANDLE_EOF ? static_cast<int64_t>(totalRead) : LastErrorCode();
+				}
+				int64_t result = bytesRead;
+#else
+				ssize_t result = pread(static_cast<int>(fileHandle), buffer + totalRead, size - totalRead, static_cast<off_t>(offset + totalRead));
+				if (result < 0)
+				{
+					if (errno == EINTR)
+					{
+						continue;
+					}
+					return LastErrorCode();
+				}
+#endif
+				if (result == 0)
+				{
+					break;
+				}
+				totalRead += static_cast<uint64_t>(result);
+			}
+			return static_cast<int64_t>(totalRead);
+		}
+
+		// Maps the range and copies it, page faults are taken on the IO worker instead of the caller
+		int64_t ReadMapped(intptr_t fileHandle, uint64_t offset, uint64_t size, uint8_t* buffer)
+		{
+#ifdef _WIN32
+			return ReadAt(fileHandle, offset, size, buffer);
+#else
+			int fd = static_cast<int>(fileHandle);
+			struct stat fileStat{};
+			if (fstat(fd, &fileStat) != 0)
+			{
+				return LastErrorCode();
+			}
+			uint64_t fileSize = static_cast<uint64_t>(fileStat.st_size);
+			if (offset >= fileSize)
+			{
+				return 0;
+			}
+			size = std::min(size, fileSize - offset);
+
+			uint64_t pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+			uint64_t mapOffset = offset & ~(pageSize - 1);
+			uint64_t mapSize = size + (offset - mapOffset);
+			void* mapping = mmap(nullptr, mapSize, PROT_READ, MAP_PRIVATE, fd, static_cast<off_t>(mapOffset));
+			if (mapping == MAP_FAILED)
+			{
+				return ReadAt(fileHandle, offset, size, buffer);
+			}
+			// Advice values are not flags, each needs its own call
+			madvise(mapping, mapSize, MADV_SEQUENTIAL);
+			madvise(mapping, mapSize, MADV_WILLNEED);
+			std::memcpy(buffer, static_cast<uint8_t*>(mapping) + (offset - mapOffset), size);
+			munmap(mapping, mapSize);
+			return static_cast<int64_t>(size);
+#endif
+		}
+	}
+
+	AsyncFileIO::AsyncFileIO(EAsyncIOBackend backend /*= EAsyncIOBackend::Auto*/, JobSystem* scheduler /*= nullptr*/)
+		: m_Scheduler(scheduler)
+	{
+#if SV_HAS_IO_URING
+		if (backend != EAsyncIOBackend::ThreadPool)
+		{
+			m_Backend = IoUringBackend::Create(scheduler);
+		}
+#endif
+		if (!m_Backend && backend == EAsyncIOBackend::IoUring)
+		{
+			std::cout << "[AsyncFileIO] io_uring not available, falling back to blocking IO workers\n";
+		}
+	}
+
+	AsyncFileIO::~AsyncFileIO()
+	{
+		while (m_BlockingReadCount.load(std::memory_order_acquire) > 0 || (m_Backend && m_Backend->HasPendingRequests()))
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	std::shared_ptr<TaskEvent> AsyncFileIO::ReadAsync(const AsyncReadDesc& desc)
+	{
+		return ReadBatchAsync({ &desc, 1 }).front();
+	}
+
+	std::vector<std::shared_ptr<TaskEvent>> AsyncFileIO::ReadBatchAsync(std::span<const AsyncReadDesc> descs)
+	{
+		std::vector<std::shared_ptr<TaskEvent>> events;
+		events.reserve(descs.size());
+		std::vector<AsyncReadRequest*> requests;
+
+		for (const AsyncReadDesc& desc : descs)
+		{
+			bool bMemoryMapped = desc.Mode == EAsyncReadMode::MemoryMapped
+				|| (desc.Mode == EAsyncReadMode::Auto && desc.Size >= LARGE_READ_THRESHOLD);
+			if (!m_Backend || bMemoryMapped)
+			{
+				events.push_back(DispatchBlockingRead(desc, bMemoryMapped));
+				continue;
+			}
+
+			std::shared_ptr<TaskEvent> event = std::make_shared<TaskEvent>();
+			events.push_back(event);
+
+			intptr_t fileHandle = OpenForRead(desc.Path);
+			if (fileHandle < 0)
+			{
+				if (desc.OutBytesRead)
+				{
+					*desc.OutBytesRead = LastErrorCode();
+				}
+				event->Complete();
+				continue;
+			}
+
+			AsyncReadRequest* request = new AsyncReadRequest();
+			request->FileHandle = fileHandle;
+			request->Offset = desc.Offset;
+			request->Size = desc.Size;
+			request->Buffer = static_cast<uint8_t*>(desc.Buffer);
+			request->OutBytesRead = desc.OutBytesRead;
+			request->Event = std::move(event);
+			requests.push_back(request);
+		}
+
+		// Single submission for the whole batch
+		if (m_Backend && !requests.empty())
+		{
+			m_Backend->Submit(requests);
+		}
+		return events;
+	}
+
+	const char* AsyncFileIO::GetBackendName() const
+	{
+		return m_Backend ? m_Backend->GetName() : "ThreadPool";
+	}
+
+	void AsyncFileIO::FinishRequest(AsyncReadRequest* request, int64_t result)
+	{
+		if (request->FileHandle >= 0)
+		{
+			CloseFile(request->FileHandle);
+		}
+		if (request->OutBytesRead)
+		{
+			*request->OutBytesRead = result;
+		}
+		std::shared_ptr<TaskEvent> event = std::move(request->Event);
+		delete request;
+		event->Complete();
+	}
+
+	std::shared_ptr<TaskEvent> AsyncFileIO::DispatchBlockingRead(const AsyncReadDesc& desc, bool bMemoryMapped)
+	{
+		m_BlockingReadCount.fetch_add(1, std::memory_order_relaxed);
+
+		TaskParams params;
+		params.Group = EWorkerGroup::BlockingIO;
+		params.Scheduler = m_Scheduler;
+		return JobTask::CreateAndDispatch(
+			[this, desc, bMemoryMapped]()
+			{
+				int64_t result = 0;
+				intptr_t fileHandle = OpenForRead(desc.Path);
+				if (fileHandle >= 0)
+				{
+					uint8_t* buffer = static_cast<uint8_t*>(desc.Buffer);
+					result = bMemoryMapped
+						? ReadMapped(fileHandle, desc.Offset, desc.Size, buffer)
+						: ReadAt(fileHandle, desc.Offset, desc.Size, buffer);
+					CloseFile(fileHandle);
+				}
+				else
+				{
+					result = LastErrorCode();
+				}
+
+				if (desc.OutBytesRead)
+				{
+					*desc.OutBytesRead = result;
+				}
+				m_BlockingReadCount.fetch_sub(1, std::memory_order_release);
+			}, {}, params);
+	}
+
+	std::shared_ptr<TaskEvent> ReadAsync(const std::string& path, uint64_t offset, uint64_t size, void* buffer, int64_t* outBytesRead /*= nullptr*/)
+	{
+		AsyncReadDesc desc;
+		desc.Path = path;
+		desc.Offset = offset;
+		desc.Size = size;
+		desc.Buffer = buffer;
+		desc.OutBytesRead = outBytesRead;
+		return JobSystem::GetCurrent().GetFileIO().ReadAsync(desc);
+	}
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include "Core/Defines.h"
+#include "Jobs/Task.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace SV
+{
+	enum class EAsyncIOBackend : uint8_t
+	{
+		Auto, // io_uring when the kernel supports it, blocking IO workers otherwise
+		IoUring,
+		ThreadPool
+	};
+
+	enum class EAsyncReadMode : uint8_t
+	{
+		Auto, // Memory mapped for reads of at least LARGE_READ_THRESHOLD bytes
+		Stream,
+		MemoryMapped
+	};
+
+	struct AsyncReadDesc
+	{
+		std::string Path;
+		uint64_t Offset = 0;
+		uint64_t Size = 0;
+		void* Buffer = nullptr; // Must stay valid until the event completes
+		int64_t* OutBytesRead = nullptr; // Optional, bytes read or negative error code, written before completion
+		EAsyncReadMode Mode = EAsyncReadMode::Auto;
+	};
+
+	// Request in flight, owned by the backend until completion
+	struct AsyncReadRequest
+	{
+		intptr_t FileHandle = -1;
+		uint64_t Offset = 0;
+		uint64_t Size = 0;
+		uint8_t* Buffer = nullptr;
+		uint64_t BytesRead = 0;
+		int64_t* OutBytesRead = nullptr;
+		std::shared_ptr<TaskEvent> Event;
+	};
+
+	class IAsyncFileBackend
+	{
+	public:
+		virtual ~IAsyncFileBackend() = default;
+
+		// Takes ownership of the requests, submits all of them with as few system calls as possible
+		virtual void Submit(std::span<AsyncReadRequest*> requests) = 0;
+		virtual bool HasPendingRequests() const = 0;
+		virtual const char* GetName() const = 0;
+	};
+
+	// Reads return a TaskEvent completed once the data is in the buffer, dependent tasks chain on it.
+	// Streamed reads go through io_uring when available, otherwise and for memory mapped reads
+	// the blocking work runs on the BlockingIO worker group.
+	class AsyncFileIO
+	{
+		NONCOPYABLE_NONMOVABLE(AsyncFileIO);
+	public:
+		static constexpr uint64_t LARGE_READ_THRESHOLD = 16ull * 1024 * 1024;
+
+		// Blocking reads and completions run on the scheduler's BlockingIO group, null uses the default instance
+		explicit AsyncFileIO(EAsyncIOBackend backend = EAsyncIOBackend::Auto, JobSystem* scheduler = nullptr);
+		~AsyncFileIO(); // Waits for reads in flight
+
+		std::shared_ptr<TaskEvent> ReadAsync(const AsyncReadDesc& desc);
+		std::vector<std::shared_ptr<TaskEvent>> ReadBatchAsync(std::span<const AsyncReadDesc> descs);
+
+		const char* GetBackendName() const;
+
+		// Completes a request, closes its file and frees it
+		static void FinishRequest(AsyncReadRequest* request, int64_t result);
+
+	private:
+		std::shared_ptr<TaskEvent> DispatchBlockingRead(const AsyncReadDesc& desc, bool bMemoryMapped);
+
+	private:
+		std::unique_ptr<IAsyncFileBackend> m_Backend; // Null when using the thread pool
+		JobSystem* m_Scheduler;
+		std::atomic<int32_t> m_BlockingReadCount{ 0 };
+	};
+
+	// Reads through the file IO of the current job system instance
+	std::shared_ptr<TaskEvent> ReadAsync(const std::string& path, uint64_t offset, uint64_t size, void* buffer, int64_t* outBytesRead = nullptr);
+}
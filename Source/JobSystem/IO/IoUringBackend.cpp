@@ -0,0 +1,345 @@
+#include "IoUringBackend.h"
+
+#if SV_HAS_IO_URING
+#include "Jobs/JobSystem.h"
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include <thread>
+
+namespace SV
+{
+	namespace
+	{
+		int IoUringSetup(uint32_t entries, io_uring_params* params)
+		{
+			return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+		}
+
+		int IoUringEnter(int ringFd, uint32_t toSubmit, uint32_t minComplete, uint32_t flags)
+		{
+			return static_cast<int>(syscall(__NR_io_uring_enter, ringFd, toSubmit, minComplete, flags, nullptr, 0));
+		}
+
+		uint32_t LoadAcquire(uint32_t* value)
+		{
+			return std::atomic_ref<uint32_t>(*value).load(std::memory_order_acquire);
+		}
+
+		void StoreRelease(uint32_t* value, uint32_t newValue)
+		{
+			std::atomic_ref<uint32_t>(*value).store(newValue, std::memory_order_release);
+		}
+	}
+
+	std::unique_ptr<IoUringBackend> IoUringBackend::Create(JobSystem* scheduler, uint32_t entries /*= 256*/)
+	{
+		std::unique_ptr<IoUringBackend> backend(new IoUringBackend());
+		backend->m_Scheduler = scheduler;
+		if (!backend->Setup(entries))
+		{
+			return nullptr;
+		}
+		return backend;
+	}
+
+	bool IoUringBackend::Setup(uint32_t entries)
+	{
+		io_uring_params params{};
+		m_RingFd = IoUringSetup(entries, &params);
+		if (m_RingFd < 0)
+		{
+			return false;
+		}
+		m_SqEntries = params.sq_entries;
+
+		m_SqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+		m_CqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+		const bool bSingleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+		if (bSingleMap)
+		{
+			m_SqRingSize = m_CqRingSize = std::max(m_SqRingSize, m_CqRingSize);
+		}
+
+		m_SqRing = mmap(nullptr, m_SqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_RingFd, IORING_OFF_SQ_RING);
+		if (m_SqRing == MAP_FAILED)
+		{
+			m_SqRing = nullptr;
+			return false;
+		}
+
+		if (bSingleMap)
+		{
+			m_CqRing = m_SqRing;
+		}
+		else
+		{
+			m_CqRing = mmap(nullptr, m_CqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_RingFd, IORING_OFF_CQ_RING);
+			if (m_CqRing == MAP_FAILED)
+			{
+				m_CqRing = nullptr;
+				return false;
+			}
+		}
+
+		m_SqesSize = params.sq_entries * sizeof(io_uring_sqe);
+		void* sqes = mmap(nullptr, m_SqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_RingFd, IORING_OFF_SQES);
+		if (sqes == MAP_FAILED)
+		{
+			return false;
+		}
+		m_Sqes = static_cast<io_uring_sqe*>(sqes);
+
+		uint8_t* sq = static_cast<uint8_t*>(m_SqRing);
+		m_SqHead = reinterpret_cast<uint32_t*>(sq + params.sq_off.head);
+		m_SqTail = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+		m_SqMask = reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+		m_SqArray = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+
+		uint8_t* cq = static_cast<uint8_t*>(m_CqRing);
+		m_CqHead = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+		m_CqTail = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+		m_CqMask = reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+		m_Cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+		return true;
+	}
+
+	IoUringBackend::~IoUringBackend()
+	{
+		if (m_Sqes)
+		{
+			munmap(m_Sqes, m_SqesSize);
+		}
+		if (m_CqRing && m_CqRing != m_SqRing)
+		{
+			munmap(m_CqRing, m_CqRingSize);
+		}
+		if (m_SqRing)
+		{
+			munmap(m_SqRing, m_SqRingSize);
+		}
+		if (m_RingFd >= 0)
+		{
+			close(m_RingFd);
+		}
+	}
+
+	void IoUringBackend::Submit(std::span<AsyncReadRequest*> requests)
+	{
+		if (requests.empty())
+		{
+			return;
+		}
+
+		// First request in flight starts the reaper
+		int32_t prevInFlight = m_InFlightCount.fetch_add(static_cast<int32_t>(requests.size()), std::memory_order_acq_rel);
+
+		{
+			std::lock_guard<std::mutex> lock(m_SubmitMutex);
+			for (AsyncReadRequest* request : requests)
+			{
+				QueueRead(request);
+			}
+			Flush();
+		}
+
+		if (prevInFlight == 0)
+		{
+			TaskParams params;
+			params.Group = EWorkerGroup::BlockingIO;
+			params.Flags = ETaskFlags::NotCancellable; // Read events complete from here
+			params.Scheduler = m_Scheduler;
+			JobTask::CreateAndDispatch([this]() { ReapCompletions(); }, {}, params);
+		}
+	}
+
+	void IoUringBackend::QueueRead(AsyncReadRequest* request)
+	{
+		if (m_DeferredRequests.empty() && TryWriteEntry(request))
+		{
+			return;
+		}
+		// Ring full, the kernel frees entries on enter. If it can't take them now the next flush retries
+		m_DeferredRequests.push_back(request);
+		Flush();
+	}
+
+	bool IoUringBackend::TryWriteEntry(AsyncReadRequest* request)
+	{
+		const uint32_t tail = *m_SqTail;
+		if (tail - LoadAcquire(m_SqHead) >= m_SqEntries)
+		{
+			return false;
+		}
+
+		uint32_t index = tail & *m_SqMask;
+		io_uring_sqe* sqe = &m_Sqes[index];
+		std::memset(sqe, 0, sizeof(io_uring_sqe));
+		sqe->opcode = IORING_OP_READ;
+		sqe->fd = static_cast<int32_t>(request->FileHandle);
+		sqe->off = request->Offset + request->BytesRead;
+		sqe->addr = reinterpret_cast<uint64_t>(request->Buffer + request->BytesRead);
+		sqe->len = static_cast<uint32_t>(std::min<uint64_t>(request->Size - request->BytesRead, UINT32_MAX));
+		sqe->user_data = reinterpret_cast<uint64_t>(request);
+
+		m_SqArray[index] = index;
+		StoreRelease(m_SqTail, tail + 1);
+		m_PendingSubmitCount++;
+		return true;
+	}
+
+	void IoUringBackend::Flush()
+	{
+		for (;;)
+		{
+			// Deferred requests take the entries freed by the previous enter, in order
+			auto firstDeferred = std::find_if_not(m_DeferredRequests.begin(), m_DeferredRequests.end(),
+				[this](AsyncReadRequest* request) { return TryWriteEntry(request); });
+			m_DeferredRequests.erase(m_DeferredRequests.begin(), firstDeferred);
+			if (m_PendingSubmitCount == 0)
+			{
+				return;
+			}
+
+			int submitted = IoUringEnter(m_RingFd, m_PendingSubmitCount, 0, 0);
+			if (submitted < 0)
+			{
+				const int32_t error = errno;
+				if (error == EINTR)
+				{
+					continue;
+				}
+				if (error == EBUSY || error == EAGAIN)
+				{
+					// Completion ring full or the kernel short on memory, only reaping helps. The reaper needs the
+					// submit lock held here, so the entries stay pending and the reaper flushes them after its next reap
+					return;
+				}
+
+				// The ring rejects them, take the entries back so their requests fail instead of waiting forever
+				const uint32_t head = LoadAcquire(m_SqHead);
+				const uint32_t tail = *m_SqTail;
+				{
+					std::lock_guard<std::mutex> lock(m_FailedMutex);
+					for (uint32_t position = head; position != tail; ++position)
+					{
+						const io_uring_sqe& sqe = m_Sqes[m_SqArray[position & *m_SqMask]];
+						m_FailedRequests.emplace_back(reinterpret_cast<AsyncReadRequest*>(sqe.user_data), -error);
+					}
+					for (AsyncReadRequest* request : m_DeferredRequests)
+					{
+						m_FailedRequests.emplace_back(request, -error);
+					}
+				}
+				m_DeferredRequests.clear();
+				StoreRelease(m_SqTail, head);
+				m_PendingSubmitCount = 0;
+				return;
+			}
+			if (submitted == 0)
+			{
+				// Nothing consumed, retried after the next reap like a busy ring
+				return;
+			}
+			m_KernelEntryCount.fetch_add(submitted, std::memory_order_release);
+			m_PendingSubmitCount -= std::min<uint32_t>(m_PendingSubmitCount, static_cast<uint32_t>(submitted));
+		}
+	}
+
+	void IoUringBackend::ReapCompletions()
+	{
+		for (;;)
+		{
+			int32_t finishedCount = 0;
+			{
+				std::lock_guard<std::mutex> lock(m_CompletionMutex);
+				uint32_t head = *m_CqHead;
+				uint32_t tail = LoadAcquire(m_CqTail);
+				m_KernelEntryCount.fetch_sub(static_cast<int32_t>(tail - head), std::memory_order_relaxed);
+				while (head != tail)
+				{
+					io_uring_cqe cqe = m_Cqes[head & *m_CqMask];
+					head++;
+					StoreRelease(m_CqHead, head);
+
+					if (HandleCompletion(reinterpret_cast<AsyncReadRequest*>(cqe.user_data), cqe.res))
+					{
+						finishedCount++;
+					}
+				}
+
+				// Includes resubmissions of the completions above that the ring rejected
+				std::vector<std::pair<AsyncReadRequest*, int32_t>> failedRequests;
+				{
+					std::lock_guard<std::mutex> failedLock(m_FailedMutex);
+					failedRequests.swap(m_FailedRequests);
+				}
+				for (const std::pair<AsyncReadRequest*, int32_t>& failed : failedRequests)
+				{
+					AsyncFileIO::FinishRequest(failed.first, failed.second);
+					finishedCount++;
+				}
+			}
+
+			{
+				// Entries a busy ring turned away, the completions reaped above made room
+				std::lock_guard<std::mutex> lock(m_SubmitMutex);
+				if (m_PendingSubmitCount > 0 || !m_DeferredRequests.empty())
+				{
+					Flush();
+				}
+			}
+
+			if (finishedCount > 0 && m_InFlightCount.fetch_sub(finishedCount, std::memory_order_acq_rel) == finishedCount)
+			{
+				// Next submission starts a new reaper
+				return;
+			}
+
+			if (m_KernelEntryCount.load(std::memory_order_acquire) > 0)
+			{
+				IoUringEnter(m_RingFd, 0, 1, IORING_ENTER_GETEVENTS);
+			}
+			else
+			{
+				// Requests are between queueing and submission, or their failure is about to be picked up
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	bool IoUringBackend::HandleCompletion(AsyncReadRequest* request, int32_t result)
+	{
+		if (result < 0)
+		{
+			if (result == -EAGAIN || result == -EINTR)
+			{
+				std::lock_guard<std::mutex> lock(m_SubmitMutex);
+				QueueRead(request);
+				Flush();
+				return false;
+			}
+			AsyncFileIO::FinishRequest(request, result);
+			return true;
+		}
+
+		request->BytesRead += static_cast<uint64_t>(result);
+		if (result > 0 && request->BytesRead < request->Size)
+		{
+			// Short read, continue from where the kernel stopped
+			std::lock_guard<std::mutex> lock(m_SubmitMutex);
+			QueueRead(request);
+			Flush();
+			return false;
+		}
+
+		AsyncFileIO::FinishRequest(request, static_cast<int64_t>(request->BytesRead));
+		return true;
+	}
+}
+#endif
@@ -0,0 +1,81 @@
+#pragma once
+#include "IO/AsyncFileIO.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define SV_HAS_IO_URING 1
+#else
+#define SV_HAS_IO_URING 0
+#endif
+
+#if SV_HAS_IO_URING
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace SV
+{
+	// Raw io_uring without liburing. Submission happens on the calling thread,
+	// a reaper task on the BlockingIO group waits for completions while reads are in flight.
+	class IoUringBackend : public IAsyncFileBackend
+	{
+	public:
+		// Null if the kernel doesn't support io_uring or it is blocked
+		static std::unique_ptr<IoUringBackend> Create(JobSystem* scheduler, uint32_t entries = 256);
+		~IoUringBackend() override;
+
+		void Submit(std::span<AsyncReadRequest*> requests) override;
+		bool HasPendingRequests() const override { return m_InFlightCount.load(std::memory_order_acquire) > 0; }
+		const char* GetName() const override { return "io_uring"; }
+
+	private:
+		IoUringBackend() = default;
+		bool Setup(uint32_t entries);
+
+		// Caller holds m_SubmitMutex. Flush never waits for the kernel, entries it can't submit stay for the reaper
+		void QueueRead(AsyncReadRequest* request);
+		bool TryWriteEntry(AsyncReadRequest* request); // False if the submission ring is full
+		void Flush();
+
+		void ReapCompletions();
+		// Returns true if the request is finished, false if resubmitted after a short read
+		bool HandleCompletion(AsyncReadRequest* request, int32_t result);
+
+	private:
+		JobSystem* m_Scheduler = nullptr; // Runs the reaper task
+		int m_RingFd = -1;
+		uint32_t m_SqEntries = 0;
+		uint32_t m_PendingSubmitCount = 0;
+
+		void* m_SqRing = nullptr;
+		void* m_CqRing = nullptr;
+		size_t m_SqRingSize = 0;
+		size_t m_CqRingSize = 0;
+		io_uring_sqe* m_Sqes = nullptr;
+		size_t m_SqesSize = 0;
+
+		uint32_t* m_SqHead = nullptr;
+		uint32_t* m_SqTail = nullptr;
+		uint32_t* m_SqMask = nullptr;
+		uint32_t* m_SqArray = nullptr;
+		uint32_t* m_CqHead = nullptr;
+		uint32_t* m_CqTail = nullptr;
+		uint32_t* m_CqMask = nullptr;
+		io_uring_cqe* m_Cqes = nullptr;
+
+		std::mutex m_SubmitMutex; // Single producer on the submission ring
+		std::vector<AsyncReadRequest*> m_DeferredRequests; // Found the submission ring full, written by the next flush
+		std::mutex m_CompletionMutex; // Single consumer on the completion ring
+		std::atomic<int32_t> m_InFlightCount{ 0 };
+		// Entries the kernel accepted and the reaper has not reaped yet, the reaper only blocks in the kernel while some exist
+		std::atomic<int32_t> m_KernelEntryCount{ 0 };
+
+		std::mutex m_FailedMutex;
+		std::vector<std::pair<AsyncReadRequest*, int32_t>> m_FailedRequests; // Rejected by io_uring_enter, failed by the reaper
+	};
+}
+#endif
@@ -1,64 +1,270 @@
 #include "JobSystem.h"
 
 #include "WorkerThread.h"
+#include "TaskPipe.h"
+#include "TaskGroup.h"
 #include "Platform/Platform.h"
 
 #include <iostream>
 #include <algorithm>
+#include <bit>
 
 namespace SV
 {
-	void JobSystem::Startup(int32_t numThreads)
+	JobSystemConfig JobSystemConfig::Default(int32_t numThreads /*= -1*/)
 	{
-		// Use config files for thread count override	
-		m_TotalWorkerCount = DetermineWorkerThreadCount(numThreads);
+		int32_t logicalCores = Platform::GetLogicalCoreCount();
+
+		JobSystemConfig config;
+		config[EWorkerGroup::Foreground].ThreadCount = JobSystem::DetermineWorkerThreadCount(numThreads);
+		config[EWorkerGroup::Foreground].Priority = EThreadPriority::Normal;
+		config[EWorkerGroup::Foreground].SpareThreadCount = std::max(1, config[EWorkerGroup::Foreground].ThreadCount / 2);
+		config[EWorkerGroup::Foreground].bAdaptiveScaling = true;
+		config[EWorkerGroup::Foreground].MinActiveThreadCount = 1;
+
+		// Oversubscribed on purpose, low priority keeps them off frame critical cores when busy
+		config[EWorkerGroup::Background].ThreadCount = std::max(1, logicalCores / 4);
+		config[EWorkerGroup::Background].Priority = EThreadPriority::Low;
+		// Opt in only, a low priority thread holding a stolen frame task stalls the frame
+		config[EWorkerGroup::Background].bStealFromOtherGroups = false;
+		config[EWorkerGroup::Background].bAdaptiveScaling = true;
+		config[EWorkerGroup::Background].MinActiveThreadCount = 0;
+
+		// Mostly sleeping in the kernel
+		config[EWorkerGroup::BlockingIO].ThreadCount = 2;
+		config[EWorkerGroup::BlockingIO].Priority = EThreadPriority::Normal;
+		config[EWorkerGroup::BlockingIO].bAdaptiveScaling = true;
+		config[EWorkerGroup::BlockingIO].MinActiveThreadCount = 0;
+		return config;
+	}
+
+	JobSystem::JobSystem(const JobSystemConfig& config /*= JobSystemConfig::Default()*/)
+	{
+		Startup(config);
+	}
+
+	JobSystem::~JobSystem()
+	{
+		Stop();
+	}
 
-		std::cout << "[JobSystem] Starting with " << m_TotalWorkerCount << " worker threads\n";
+	void JobSystem::Stop(EShutdownMode mode /*= EShutdownMode::Drain*/, std::chrono::milliseconds drainTimeout /*= std::chrono::milliseconds(1000)*/)
+	{
+		if (m_bStopped)
+		{
+			return;
+		}
+		m_bStopped = true;
+		RequestShutdown(mode, drainTimeout);
+	}
+
+	JobSystem* JobSystem::GetCurrentInstance()
+	{
+		WorkerThread* worker = WorkerThread::GetCurrent();
+		return worker ? worker->GetJobSystem() : nullptr;
+	}
+
+	void JobSystem::Startup(const JobSystemConfig& config)
+	{
+		m_TotalWorkerCount = 0;
+		for (size_t groupIndex = 0; groupIndex < m_Groups.size(); ++groupIndex)
+		{
+			WorkerGroup& group = m_Groups[groupIndex];
+			group.Config = config.Groups[groupIndex];
+			group.FirstWorkerIndex = m_TotalWorkerCount;
+			group.WorkerCount = std::max(0, group.Config.ThreadCount);
+			group.SpareCount = group.WorkerCount > 0 ? std::max(0, group.Config.SpareThreadCount) : 0;
+			m_TotalWorkerCount += group.WorkerCount + group.SpareCount;
+
+			group.MaxActiveCount = group.WorkerCount;
+			group.MinActiveCount = std::clamp(group.Config.MinActiveThreadCount, 0, group.WorkerCount);
+			group.ActiveWorkerCount = group.WorkerCount;
+			group.GlobalQueue.SetCapacity(group.Config.QueueCapacity);
+		}
+		assert(GetGroup(EWorkerGroup::Foreground).WorkerCount > 0 && "Foreground group requires at least one worker!");
+
+		m_bVerbose = config.bVerbose;
+		m_bCalibrateSpinning = config.bCalibrateSpinning;
+		if (config.bLabelStats)
+		{
+			m_LabelStats = std::make_unique<TaskLabelStats>(m_TotalWorkerCount);
+		}
+		m_FileIO = std::make_unique<AsyncFileIO>(config.FileIOBackend, this);
+		if (!config.bLazyWorkerStartup)
+		{
+			EnsureWorkersStarted();
+		}
+	}
+
+	void JobSystem::EnsureWorkersStarted()
+	{
+		if (!m_bWorkersStarted.load(std::memory_order_acquire))
+		{
+			std::call_once(m_StartWorkersFlag, [this]() { StartWorkers(); });
+		}
+	}
+
+	void JobSystem::StartWorkers()
+	{
+		// Before the workers exist, so they don't disturb the measurements
+		if (m_bCalibrateSpinning)
+		{
+			SpinPolicy::Calibrate();
+		}
+		if (m_bVerbose)
+		{
+			std::cout << "[JobSystem] Starting with " << m_TotalWorkerCount << " worker threads\n";
+			const SpinSettings spinSettings = SpinPolicy::GetSettings();
+			std::cout << "[JobSystem] Spin budgets: idle " << spinSettings.IdleSpinCount << ", wait " << spinSettings.WaitSpinCount
+				<< ", worker wait slice " << spinSettings.WorkerWaitSlice.count() << " us (pause " << spinSettings.PauseCost.count()
+				<< " ns, wake " << spinSettings.WakeLatency.count() << " ns, steal round trip " << spinSettings.StealRoundTrip.count() << " ns)\n";
+		}
 		m_WorkerHandles.reserve(m_TotalWorkerCount);
 
 		// Use platform abstraction class instead (PlatformMisc)
 		int32_t logicalCores = Platform::GetLogicalCoreCount();
-		int32_t startCore = logicalCores - m_TotalWorkerCount;
 
-		for (uint32_t i = 0; i < m_TotalWorkerCount; i++)
+		for (size_t groupIndex = 0; groupIndex < m_Groups.size(); ++groupIndex)
 		{
-			std::unique_ptr<WorkerThread> runnable = std::make_unique<WorkerThread>(i, this);
-			WorkerThread* runnablePtr = runnable.get();
+			const EWorkerGroup groupId = static_cast<EWorkerGroup>(groupIndex);
+			const WorkerGroup& group = m_Groups[groupIndex];
+			int32_t startCore = std::max(0, logicalCores - group.WorkerCount);
 
-			std::unique_ptr<Thread> workerHandle = Thread::Create(
-				std::move(runnable), 
-				"Worker_" + std::to_string(i),
-				EThreadPriority::Low
-			);
-			int32_t coreIndex = startCore + i;
-			Platform::SetThreadAffinity(workerHandle->GetHandle(), 1ull << coreIndex);
+			for (int32_t i = 0; i < group.WorkerCount + group.SpareCount; i++)
+			{
+				int32_t workerId = group.FirstWorkerIndex + i;
+				const bool bSpare = i >= group.WorkerCount;
+				std::unique_ptr<WorkerThread> runnable = std::make_unique<WorkerThread>(workerId, groupId, this, bSpare);
+				WorkerThread* runnablePtr = runnable.get();
+				runnablePtr->SetQueueCapacity(group.Config.QueueCapacity);
+				std::string threadName = runnable->GetThreadName();
+
+				std::unique_ptr<Thread> workerHandle = Thread::Create(
+					std::move(runnable),
+					threadName,
+					group.Config.Priority
+				);
+
+				if (group.Config.AffinityMask != 0)
+				{
+					Platform::SetThreadAffinity(workerHandle->GetHandle(), group.Config.AffinityMask);
+				}
+				else if (groupId == EWorkerGroup::Foreground && !bSpare)
+				{
+					int32_t coreIndex = (startCore + i) % logicalCores;
+					Platform::SetThreadAffinity(workerHandle->GetHandle(), 1ull << coreIndex);
+					runnablePtr->SetPinnedCore(coreIndex);
+				}
+				if (std::has_single_bit(group.Config.AffinityMask))
+				{
+					runnablePtr->SetPinnedCore(std::countr_zero(group.Config.AffinityMask));
+				}
 
-			m_WorkerMap[workerHandle->GetId()] = runnablePtr;
-			m_WorkerHandles.push_back(std::move(workerHandle));
-			m_WorkerHandles.back()->Launch();
+				m_WorkerMap[workerHandle->GetId()] = runnablePtr;
+				m_WorkerHandles.push_back(std::move(workerHandle));
+			}
 		}
 
-		while (m_ReadyWorkerCount.load(std::memory_order_acquire) < m_TotalWorkerCount)
+		// Launch only after the worker map is complete, workers read it without locking.
+		// Nobody waits for the workers to come up, tasks queue until they do
+		m_bWorkersStarted.store(true, std::memory_order_release);
+		for (std::unique_ptr<Thread>& workerHandle : m_WorkerHandles)
 		{
-			std::this_thread::yield();
+			workerHandle->Launch();
 		}
-
-		std::cout << "[JobSystem] All workers ready\n";
 	}
 
-	void JobSystem::RequestShutdown()
+	void JobSystem::RequestShutdown(EShutdownMode mode, std::chrono::milliseconds drainTimeout)
 	{
-		std::cout << "[JobSystem] Shutdown requested\n";
+		if (m_bVerbose)
+		{
+			std::cout << "[JobSystem] Shutdown requested\n";
+		}
+
+		// Reads in flight complete on workers
+		m_FileIO.reset();
+
+		if (m_bWorkersStarted.load(std::memory_order_acquire))
+		{
+			// Periodic timers would keep the queues busy forever
+			AbandonTimers();
+			if (mode == EShutdownMode::Drain && !WaitForInFlightTasks(std::chrono::steady_clock::now() + drainTimeout))
+			{
+				if (m_bVerbose)
+				{
+					std::cout << "[JobSystem] Drain timed out with " << m_InFlightTaskCount.load(std::memory_order_relaxed) << " tasks left, cancelling\n";
+				}
+			}
+
+			// Whatever is still queued is abandoned, its subsequents are dispatched and abandoned in turn
+			m_bCancellingTasks.store(true, std::memory_order_release);
+			AbandonTimers();
+			UnparkAllWorkers();
+			WaitForInFlightTasks(std::chrono::steady_clock::time_point::max());
+		}
 
 		m_ShutdownRequested.store(true, std::memory_order_release);
-		m_GlobalQueue.NotifyAll();
+		// Stop and join everything before destroying, workers still steal from each other until they exit
+		for (std::unique_ptr<Thread>& workerHandle : m_WorkerHandles)
+		{
+			workerHandle->RequestStop();
+		}
+		for (std::unique_ptr<Thread>& workerHandle : m_WorkerHandles)
+		{
+			workerHandle->Join();
+		}
 		m_WorkerHandles.clear();
 		m_WorkerMap.clear();
 
-		std::cout << "[JobSystem] Shutdown complete\n";
+		if (m_bVerbose)
+		{
+			std::cout << "[JobSystem] Shutdown complete\n";
+		}
+	}
+
+	void JobSystem::AbandonTimers()
+	{
+		std::vector<std::shared_ptr<JobTask>> pending;
+		m_TimerWheel.CancelAll(pending);
+		for (std::shared_ptr<JobTask>& task : pending)
+		{
+			if (auto event = task->GetEvent())
+			{
+				event->Abandon();
+			}
+		}
+	}
+
+	void JobSystem::UnparkAllWorkers()
+	{
+		for (WorkerGroup& group : m_Groups)
+		{
+			if (group.WorkerCount == 0)
+			{
+				continue;
+			}
+			std::lock_guard<std::mutex> lock(group.ScalingMutex);
+			group.MaxActiveCount.store(group.WorkerCount, std::memory_order_relaxed);
+			while (UnparkWorker(group))
+			{
+			}
+		}
 	}
 
-	int32_t JobSystem::DetermineWorkerThreadCount(int32_t requestedCount) const
+	bool JobSystem::WaitForInFlightTasks(std::chrono::steady_clock::time_point deadline)
+	{
+		while (m_InFlightTaskCount.load(std::memory_order_acquire) > 0)
+		{
+			if (std::chrono::steady_clock::now() >= deadline)
+			{
+				return false;
+			}
+			std::this_thread::yield();
+		}
+		return true;
+	}
+
+	int32_t JobSystem::DetermineWorkerThreadCount(int32_t requestedCount)
 	{
 		int32_t logicalCores = Platform::GetLogicalCoreCount();
 
@@ -78,50 +284,245 @@ namespace SV
 		{
 			return maxWorkers;
 		}
-		// perhaps, consider number of IO threads and background threads
+		// Background and IO groups are sized separately, see JobSystemConfig::Default
 
 		return std::clamp(requestedCount, 1, maxWorkers);
 	}
 
 	void JobSystem::DispatchTask(std::shared_ptr<JobTask> task)
 	{
+		EnsureWorkersStarted();
+		m_InFlightTaskCount.fetch_add(1, std::memory_order_relaxed);
+		task->SetScheduler(this);
+		if (IsTaskTimed(*task))
+		{
+			task->MarkReady();
+		}
+
+		if (TaskPipe* pipe = task->GetPipe())
+		{
+			// Pipe schedules its own drain task
+			pipe->PushReadyTask(std::move(task));
+			return;
+		}
+
+		WorkerGroup* group = &GetTargetGroup(*task);
+		if (task->HasDeadline())
+		{
+			m_QueuedDeadlineTaskCount.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		int32_t affinityWorkerId = task->HasAffinity() ? ResolveAffinityWorker(*task) : -1;
+		if (affinityWorkerId >= 0 && task->GetDesiredThread() == ENamedThreads::AnyThread)
+		{
+			WorkerThread* target = GetWorker(affinityWorkerId);
+			const bool bStealable = !task->HasFlags(ETaskFlags::HardAffinity);
+			TaskMailbox& mailbox = target->GetMailbox();
+			mailbox.Push(std::move(task));
+
+			// Pairs with the mailbox check in TryParkWorker
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (target->IsParked())
+			{
+				UnparkWorker(*group, *target);
+			}
+			else if (bStealable)
+			{
+				// Someone has to be around to steal it if the target stays busy past the steal delay
+				WakeWorkerIfNeeded(*group, mailbox.Size());
+			}
+			return;
+		}
+
 		ENamedThreads desiredThread = task->GetDesiredThread();
 		if (desiredThread == ENamedThreads::AnyThread)
 		{
-			// Check if we are on a worker thread
-			std::thread::id currentThreadId = std::this_thread::get_id();
-			auto it = m_WorkerMap.find(currentThreadId);
-
-			if (it != m_WorkerMap.end())
+			// Check if we are on a worker thread of the target group
+			WorkerThread* worker = GetCurrentWorker();
+			if (worker && &GetGroup(worker->GetGroup()) == group)
 			{
 				// On worker
-				it->second->GetLocalQueue()->Push(task);
+				ITaskQueue* localQueue = worker->GetLocalQueue();
+				if (!localQueue->TryPush(task))
+				{
+					PushWithBackpressure(*group, *localQueue, std::move(task));
+					return;
+				}
+				WakeWorkerIfNeeded(*group, localQueue->Size());
 			}
 			else
 			{
-				// on game thread
-				m_GlobalQueue.Push(task);
+				// on game thread or another group
+				if (!group->GlobalQueue.TryPush(task))
+				{
+					PushWithBackpressure(*group, group->GlobalQueue, std::move(task));
+					return;
+				}
+				WakeWorkerIfNeeded(*group, group->GlobalQueue.Size());
 			}
 		}
 		else
 		{
 			// Named thread execution
 			// TODO: Implement named thread queues
-			m_GlobalQueue.Push(task);
+			WorkerGroup& foreground = GetGroup(EWorkerGroup::Foreground);
+			foreground.GlobalQueue.Push(task);
+			WakeWorkerIfNeeded(foreground, foreground.GlobalQueue.Size());
 		}
 	}
 
-	std::shared_ptr<JobTask> JobSystem::PopGlobalQueue()
+	std::shared_ptr<JobTask> JobSystem::PopGlobalQueue(EWorkerGroup group)
 	{
-		return m_GlobalQueue.Pop();
+		return GetGroup(group).GlobalQueue.Pop();
 	}
 
 	std::shared_ptr<JobTask> JobSystem::StealTaskFor(int32_t thiefId)
 	{
-		// Steal in round-robin fashion
-		for (int32_t i = 0; i < m_TotalWorkerCount; ++i)
+		WorkerThread* thief = GetWorker(thiefId);
+		const WorkerGroup& thiefGroup = GetGroup(thief->GetGroup());
+
+		std::shared_ptr<JobTask> stolen = StealFromGroup(thiefGroup, thiefId);
+		if (stolen || !thiefGroup.Config.bStealFromOtherGroups)
+		{
+			return stolen;
+		}
+
+		for (WorkerGroup& group : m_Groups)
+		{
+			if (&group == &thiefGroup || group.WorkerCount == 0)
+			{
+				continue;
+			}
+			stolen = group.GlobalQueue.Pop();
+			if (!stolen)
+			{
+				stolen = StealFromGroup(group, thiefId);
+			}
+			if (stolen)
+			{
+				return stolen;
+			}
+		}
+		return nullptr;
+	}
+
+	std::shared_ptr<JobTask> JobSystem::PopEarliestDeadlineTask(int32_t workerId)
+	{
+		WorkerThread* worker = GetWorker(workerId);
+		const WorkerGroup& workerGroup = GetGroup(worker->GetGroup());
+
+		// Compare the mirrored deadlines without locking, then pop from the winner only
+		ITaskQueue* bestQueue = nullptr;
+		std::chrono::steady_clock::time_point bestDeadline = std::chrono::steady_clock::time_point::max();
+		auto consider = [&bestQueue, &bestDeadline](ITaskQueue* queue)
+			{
+				std::chrono::steady_clock::time_point deadline = queue->GetEarliestDeadline();
+				if (deadline < bestDeadline)
+				{
+					bestDeadline = deadline;
+					bestQueue = queue;
+				}
+			};
+		auto considerGroup = [this, &consider](WorkerGroup& group)
+			{
+				consider(&group.GlobalQueue);
+				for (int32_t i = 0; i < group.WorkerCount + group.SpareCount; ++i)
+				{
+					consider(GetWorker(group.FirstWorkerIndex + i)->GetLocalQueue());
+				}
+			};
+
+		for (WorkerGroup& group : m_Groups)
+		{
+			if (&group == &workerGroup || (workerGroup.Config.bStealFromOtherGroups && group.WorkerCount > 0))
+			{
+				considerGroup(group);
+			}
+		}
+
+		return bestQueue ? bestQueue->PopEarliestDeadline() : nullptr;
+	}
+
+	int32_t JobSystem::ResolveAffinityWorker(const JobTask& task)
+	{
+		const WorkerGroup& group = GetTargetGroup(task);
+		const TaskParams& params = task.GetParams();
+		if (params.PreferredWorker >= 0)
+		{
+			return group.FirstWorkerIndex + params.PreferredWorker % group.WorkerCount;
+		}
+
+		for (int32_t i = 0; i < group.WorkerCount; ++i)
+		{
+			int32_t core = GetWorker(group.FirstWorkerIndex + i)->GetPinnedCore();
+			if (core >= 0 && core < 64 && (params.PreferredCpuMask & (1ull << core)) != 0)
+			{
+				return group.FirstWorkerIndex + i;
+			}
+		}
+		return -1;
+	}
+
+	JobSystem::WorkerGroup& JobSystem::GetTargetGroup(const JobTask& task)
+	{
+		WorkerGroup& group = GetGroup(task.GetGroup());
+		return group.WorkerCount > 0 ? group : GetGroup(EWorkerGroup::Foreground);
+	}
+
+	void JobSystem::RecordTaskExecution(const JobTask& task, int32_t workerId, std::chrono::steady_clock::time_point startTime, std::chrono::steady_clock::time_point endTime)
+	{
+		if (task.GetTraceId() != 0)
+		{
+			m_GraphRecorder.RecordExecution(task.GetTraceId(), workerId, task.GetReadyTime(), startTime, endTime);
+		}
+		if (task.GetParams().Label && m_LabelStats)
+		{
+			const std::chrono::nanoseconds queueLatency = startTime - task.GetReadyTime();
+			const std::chrono::nanoseconds duration = endTime - startTime;
+			m_LabelStats->Record(workerId, task.GetParams().Label, queueLatency.count(), duration.count());
+		}
+	}
+
+	void JobSystem::RecordDeadlineTaskCompleted(const JobTask& task, std::chrono::steady_clock::time_point completionTime, bool bQueued)
+	{
+		if (bQueued)
+		{
+			m_QueuedDeadlineTaskCount.fetch_sub(1, std::memory_order_relaxed);
+		}
+		m_DeadlineCompletedCount.fetch_add(1, std::memory_order_relaxed);
+		if (completionTime <= task.GetDeadline())
+		{
+			return;
+		}
+
+		m_DeadlineMissCount.fetch_add(1, std::memory_order_relaxed);
+		int64_t latenessUs = std::chrono::duration_cast<std::chrono::microseconds>(completionTime - task.GetDeadline()).count();
+		int64_t maxLatenessUs = m_DeadlineMaxLatenessUs.load(std::memory_order_relaxed);
+		while (latenessUs > maxLatenessUs && !m_DeadlineMaxLatenessUs.compare_exchange_weak(maxLatenessUs, latenessUs, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	DeadlineStats JobSystem::ConsumeDeadlineStats()
+	{
+		DeadlineStats stats;
+		stats.CompletedCount = m_DeadlineCompletedCount.exchange(0, std::memory_order_relaxed);
+		stats.MissCount = m_DeadlineMissCount.exchange(0, std::memory_order_relaxed);
+		stats.MaxLateness = std::chrono::microseconds(m_DeadlineMaxLatenessUs.exchange(0, std::memory_order_relaxed));
+		return stats;
+	}
+
+	std::shared_ptr<JobTask> JobSystem::StealFromGroup(const WorkerGroup& group, int32_t thiefId)
+	{
+		// Steal in round-robin fashion, active spares included
+		const int32_t victimCount = group.WorkerCount + group.SpareCount;
+		for (int32_t i = 0; i < victimCount; ++i)
 		{
-			int32_t victimId = (thiefId + i + 1) % m_TotalWorkerCount;
+			int32_t victimId = group.FirstWorkerIndex + (thiefId + i + 1) % victimCount;
+			if (victimId == thiefId)
+			{
+				continue;
+			}
 
 			auto& victim = m_WorkerHandles[victimId];
 			ITaskQueue* victimQueue = victim->GetRunnable()->GetLocalQueue();
@@ -133,34 +534,423 @@ namespace SV
 					return stolen;
 				}
 			}
+
+			// Targeted tasks the victim didn't get to in time
+			std::shared_ptr<JobTask> stolen = GetWorker(victimId)->GetMailbox().Steal(group.Config.AffinityStealDelay);
+			if (stolen)
+			{
+				return stolen;
+			}
 		}
 
 		return nullptr;
 	}
 
 
-	bool JobSystem::IsWorkerThread(std::thread::id threadId)
+	void JobSystem::EnterBlockingRegion()
 	{
-		return m_WorkerMap.find(threadId) != m_WorkerMap.end();
+		WorkerThread* worker = GetCurrentWorker();
+		if (!worker || !worker->EnterBlockingRegion())
+		{
+			return;
+		}
+
+		WorkerGroup& group = GetGroup(worker->GetGroup());
+		int32_t blockedCount = group.BlockedCount.fetch_add(1, std::memory_order_acq_rel) + 1;
+		if (group.ActiveSpareCount.load(std::memory_order_acquire) >= blockedCount)
+		{
+			return;
+		}
+
+		for (int32_t i = 0; i < group.SpareCount; ++i)
+		{
+			WorkerThread* spare = GetWorker(group.FirstWorkerIndex + group.WorkerCount + i);
+			if (spare != worker && spare->TryUnpark())
+			{
+				int32_t activeCount = group.ActiveSpareCount.fetch_add(1, std::memory_order_acq_rel) + 1;
+				int32_t peakCount = group.PeakActiveSpareCount.load(std::memory_order_relaxed);
+				while (activeCount > peakCount && !group.PeakActiveSpareCount.compare_exchange_weak(peakCount, activeCount, std::memory_order_relaxed))
+				{
+				}
+				return;
+			}
+		}
+		// All spares busy, oversubscription cap reached
 	}
 
-	WorkerThread* JobSystem::GetCurrentWorker()
+	void JobSystem::LeaveBlockingRegion()
 	{
-		std::thread::id currentThreadId = std::this_thread::get_id();
-		auto it = m_WorkerMap.find(currentThreadId);
-		if (it != m_WorkerMap.end())
+		WorkerThread* worker = GetCurrentWorker();
+		if (!worker || !worker->LeaveBlockingRegion())
 		{
-			return it->second;
+			return;
 		}
-		return nullptr;
+
+		WorkerGroup& group = GetGroup(worker->GetGroup());
+		int32_t blockedCount = group.BlockedCount.fetch_sub(1, std::memory_order_acq_rel) - 1;
+		if (group.ActiveSpareCount.load(std::memory_order_acquire) <= blockedCount)
+		{
+			return;
+		}
+
+		for (int32_t i = 0; i < group.SpareCount; ++i)
+		{
+			WorkerThread* spare = GetWorker(group.FirstWorkerIndex + group.WorkerCount + i);
+			if (spare->TryPark())
+			{
+				group.ActiveSpareCount.fetch_sub(1, std::memory_order_acq_rel);
+				return;
+			}
+		}
+	}
+
+	void JobSystem::SetActiveWorkerCount(EWorkerGroup group, int32_t count)
+	{
+		SetActiveWorkerBounds(group, count, count);
+	}
+
+	void JobSystem::SetActiveWorkerBounds(EWorkerGroup groupId, int32_t minCount, int32_t maxCount)
+	{
+		WorkerGroup& group = GetGroup(groupId);
+		if (group.WorkerCount == 0)
+		{
+			return;
+		}
+
+		EnsureWorkersStarted();
+		std::lock_guard<std::mutex> lock(group.ScalingMutex);
+		const int32_t maxActive = std::clamp(maxCount, 1, group.WorkerCount);
+		group.MaxActiveCount.store(maxActive, std::memory_order_relaxed);
+		group.MinActiveCount.store(std::clamp(minCount, 0, maxActive), std::memory_order_relaxed);
+
+		// Workers above the maximum park themselves once idle
+		while (group.ActiveWorkerCount.load(std::memory_order_relaxed) < group.MinActiveCount.load(std::memory_order_relaxed))
+		{
+			if (!UnparkWorker(group))
+			{
+				break;
+			}
+		}
+	}
+
+	void JobSystem::SetWorkerSearching(const WorkerThread& worker, bool bSearching)
+	{
+		if (worker.IsSpare())
+		{
+			return;
+		}
+		GetGroup(worker.GetGroup()).SearchingCount.fetch_add(bSearching ? 1 : -1, std::memory_order_seq_cst);
 	}
 
-	void JobSystem::WorkerThreadReady()
+	bool JobSystem::TryParkWorker(WorkerThread& worker, std::chrono::steady_clock::duration idleTime)
 	{
-		m_ReadyWorkerCount.fetch_add(1, std::memory_order_release);
-		while (m_ReadyWorkerCount.load(std::memory_order_acquire) < m_TotalWorkerCount) { std::this_thread::yield(); }
+		if (worker.IsSpare())
+		{
+			return false;
+		}
+
+		WorkerGroup& group = GetGroup(worker.GetGroup());
+		auto canPark = [&group, idleTime](bool& bOverLimit)
+			{
+				int32_t activeCount = group.ActiveWorkerCount.load(std::memory_order_relaxed);
+				bOverLimit = activeCount > group.MaxActiveCount.load(std::memory_order_relaxed);
+				return bOverLimit
+					|| (group.Config.bAdaptiveScaling && idleTime >= group.Config.IdleParkTime
+						&& activeCount > group.MinActiveCount.load(std::memory_order_relaxed));
+			};
+
+		bool bOverLimit = false;
+		if (!canPark(bOverLimit))
+		{
+			return false;
+		}
+
+		std::lock_guard<std::mutex> lock(group.ScalingMutex);
+		if (!canPark(bOverLimit) || !worker.TryPark())
+		{
+			return false;
+		}
+		group.SearchingCount.fetch_sub(1, std::memory_order_seq_cst);
+		group.ActiveWorkerCount.fetch_sub(1, std::memory_order_relaxed);
+		group.ParkedCount.fetch_add(1, std::memory_order_seq_cst);
+
+		// Pairs with the fence in WakeWorkerIfNeeded, a task pushed before the parked count was visible is seen here
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if ((!worker.GetMailbox().IsEmpty() || (!bOverLimit && HasStealableWork(group))) && worker.TryUnpark())
+		{
+			group.ParkedCount.fetch_sub(1, std::memory_order_relaxed);
+			group.ActiveWorkerCount.fetch_add(1, std::memory_order_relaxed);
+			group.SearchingCount.fetch_add(1, std::memory_order_seq_cst);
+			return false;
+		}
+		return true;
 	}
 
+	bool JobSystem::HasStealableWork(const WorkerGroup& group)
+	{
+		if (!group.GlobalQueue.IsEmpty())
+		{
+			return true;
+		}
+		// Soft affinity tasks wait out the steal delay, someone has to stay around to take them
+		for (int32_t i = 0; i < group.WorkerCount; ++i)
+		{
+			if (GetWorker(group.FirstWorkerIndex + i)->GetMailbox().HasStealable())
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void JobSystem::WakeWorkerIfNeeded(WorkerGroup& group, size_t queueDepth)
+	{
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (group.ParkedCount.load(std::memory_order_relaxed) == 0)
+		{
+			return;
+		}
+
+		// Searching workers pick the task up themselves
+		int32_t searchingCount = group.SearchingCount.load(std::memory_order_relaxed);
+		if (searchingCount > 0 && queueDepth <= static_cast<size_t>(searchingCount))
+		{
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(group.ScalingMutex);
+		if (group.ActiveWorkerCount.load(std::memory_order_relaxed) < group.MaxActiveCount.load(std::memory_order_relaxed))
+		{
+			UnparkWorker(group);
+		}
+	}
+
+	bool JobSystem::UnparkWorker(WorkerGroup& group)
+	{
+		for (int32_t i = 0; i < group.WorkerCount; ++i)
+		{
+			if (GetWorker(group.FirstWorkerIndex + i)->TryUnpark())
+			{
+				group.ParkedCount.fetch_sub(1, std::memory_order_relaxed);
+				group.ActiveWorkerCount.fetch_add(1, std::memory_order_relaxed);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void JobSystem::UnparkWorker(WorkerGroup& group, WorkerThread& worker)
+	{
+		std::lock_guard<std::mutex> lock(group.ScalingMutex);
+		if (worker.TryUnpark())
+		{
+			group.ParkedCount.fetch_sub(1, std::memory_order_relaxed);
+			group.ActiveWorkerCount.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	void JobSystem::PushWithBackpressure(WorkerGroup& group, ITaskQueue& queue, std::shared_ptr<JobTask> task)
+	{
+		// Tasks run on the producer may dispatch into the same full queue again, past this depth the bound gives way
+		constexpr int32_t MAX_BACKPRESSURE_DEPTH = 16;
+		static thread_local int32_t s_BackpressureDepth = 0;
+
+		group.BackpressureCount.fetch_add(1, std::memory_order_relaxed);
+		if (s_BackpressureDepth >= MAX_BACKPRESSURE_DEPTH)
+		{
+			queue.Push(std::move(task));
+			WakeWorkerIfNeeded(group, queue.Size());
+			return;
+		}
+		++s_BackpressureDepth;
+
+		WorkerThread* worker = GetCurrentWorker();
+		EBackpressurePolicy policy = group.Config.BackpressurePolicy;
+		if (policy == EBackpressurePolicy::RunInline && !task->CanRunInline())
+		{
+			policy = EBackpressurePolicy::HelpDrain;
+		}
+		else if (policy == EBackpressurePolicy::Block && worker)
+		{
+			policy = EBackpressurePolicy::HelpDrain;
+		}
+
+		if (policy == EBackpressurePolicy::RunInline)
+		{
+			RunTaskOnCaller(std::move(task));
+		}
+		else
+		{
+			const bool bGlobalQueue = &queue == &group.GlobalQueue;
+			while (!queue.TryPush(task))
+			{
+				if (policy == EBackpressurePolicy::HelpDrain)
+				{
+					// A full local queue belongs to the calling worker, its own pops drain it
+					if (!bGlobalQueue && worker->TryExecuteTask())
+					{
+						continue;
+					}
+					if (bGlobalQueue)
+					{
+						if (std::shared_ptr<JobTask> queued = group.GlobalQueue.Pop())
+						{
+							RunTaskOnCaller(std::move(queued));
+							continue;
+						}
+					}
+				}
+				if (bGlobalQueue)
+				{
+					group.GlobalQueue.WaitForSpace(std::chrono::steady_clock::now() + SpinPolicy::GetWorkerWaitSlice());
+				}
+				else
+				{
+					Platform::YieldThread();
+				}
+			}
+			WakeWorkerIfNeeded(group, queue.Size());
+		}
+		--s_BackpressureDepth;
+	}
+
+	void JobSystem::RunTaskOnCaller(std::shared_ptr<JobTask> task)
+	{
+		if (WorkerThread* worker = GetCurrentWorker())
+		{
+			worker->ExecuteTask(std::move(task));
+			return;
+		}
+
+		// Same steps as a worker, without continuation inlining
+		const bool bCancelled = IsCancellingTasks() && !task->HasFlags(ETaskFlags::NotCancellable);
+		const bool bTimed = !bCancelled && IsTaskTimed(*task);
+		const std::chrono::steady_clock::time_point startTime = bTimed ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+		if (!bCancelled)
+		{
+			task->DoTask();
+		}
+		if (bTimed)
+		{
+			RecordTaskExecution(*task, -1, startTime, std::chrono::steady_clock::now());
+		}
+		if (task->HasDeadline())
+		{
+			RecordDeadlineTaskCompleted(*task, std::chrono::steady_clock::now(), true);
+		}
+		if (TaskGroup* taskGroup = task->GetTaskGroup())
+		{
+			taskGroup->OnBranchDone();
+		}
+		if (auto event = task->GetEvent())
+		{
+			if (bCancelled)
+			{
+				event->Abandon();
+			}
+			else
+			{
+				event->Complete();
+			}
+		}
+		OnTaskRetired();
+	}
+
+	JobSystemStats JobSystem::GetStats(EWorkerGroup groupId) const
+	{
+		const WorkerGroup& group = GetGroup(groupId);
+
+		JobSystemStats stats;
+		stats.WorkerCount = group.WorkerCount;
+		stats.SpareWorkerCount = group.SpareCount;
+		stats.BlockedWorkerCount = group.BlockedCount.load(std::memory_order_relaxed);
+		stats.ActiveSpareWorkerCount = group.ActiveSpareCount.load(std::memory_order_relaxed);
+		stats.PeakActiveSpareWorkerCount = group.PeakActiveSpareCount.load(std::memory_order_relaxed);
+		stats.ActiveWorkerCount = group.ActiveWorkerCount.load(std::memory_order_relaxed);
+		stats.ParkedWorkerCount = group.ParkedCount.load(std::memory_order_relaxed);
+		stats.GlobalQueueHighWaterMark = group.GlobalQueue.GetHighWaterMark();
+		stats.BackpressureCount = group.BackpressureCount.load(std::memory_order_relaxed);
+		if (m_bWorkersStarted.load(std::memory_order_acquire))
+		{
+			for (int32_t i = 0; i < group.WorkerCount + group.SpareCount; ++i)
+			{
+				WorkerThread* worker = static_cast<WorkerThread*>(m_WorkerHandles[group.FirstWorkerIndex + i]->GetRunnable());
+				stats.LocalQueueHighWaterMark = std::max(stats.LocalQueueHighWaterMark, worker->GetLocalQueue()->GetHighWaterMark());
+				const TaskMemory& taskMemory = worker->GetTaskMemory();
+				stats.ScratchHighWaterMark = std::max(stats.ScratchHighWaterMark, taskMemory.GetScratchHighWaterMark());
+				stats.FrameHighWaterMark = std::max(stats.FrameHighWaterMark, taskMemory.GetFrameHighWaterMark());
+			}
+		}
+		return stats;
+	}
+
+	JobSystemStats JobSystem::GetStats() const
+	{
+		JobSystemStats total;
+		for (size_t groupIndex = 0; groupIndex < m_Groups.size(); ++groupIndex)
+		{
+			JobSystemStats stats = GetStats(static_cast<EWorkerGroup>(groupIndex));
+			total.WorkerCount += stats.WorkerCount;
+			total.SpareWorkerCount += stats.SpareWorkerCount;
+			total.BlockedWorkerCount += stats.BlockedWorkerCount;
+			total.ActiveSpareWorkerCount += stats.ActiveSpareWorkerCount;
+			total.PeakActiveSpareWorkerCount += stats.PeakActiveSpareWorkerCount;
+			total.ActiveWorkerCount += stats.ActiveWorkerCount;
+			total.ParkedWorkerCount += stats.ParkedWorkerCount;
+			total.GlobalQueueHighWaterMark = std::max(total.GlobalQueueHighWaterMark, stats.GlobalQueueHighWaterMark);
+			total.LocalQueueHighWaterMark = std::max(total.LocalQueueHighWaterMark, stats.LocalQueueHighWaterMark);
+			total.BackpressureCount += stats.BackpressureCount;
+			total.ScratchHighWaterMark = std::max(total.ScratchHighWaterMark, stats.ScratchHighWaterMark);
+			total.FrameHighWaterMark = std::max(total.FrameHighWaterMark, stats.FrameHighWaterMark);
+		}
+		return total;
+	}
+
+	void JobSystem::ServiceTimers()
+	{
+		if (m_TimerWheel.IsEmpty())
+		{
+			return;
+		}
+
+		std::vector<std::shared_ptr<JobTask>> expired;
+		m_TimerWheel.Advance(std::chrono::steady_clock::now(), expired);
+		for (std::shared_ptr<JobTask>& task : expired)
+		{
+			DispatchTask(std::move(task));
+		}
+	}
+
+	WorkerThread* JobSystem::GetWorker(int32_t workerId)
+	{
+		return static_cast<WorkerThread*>(m_WorkerHandles[workerId]->GetRunnable());
+	}
+
+	void JobSystem::WakeTimerKeeper()
+	{
+		// Timers need the keeper running
+		EnsureWorkersStarted();
+		WorkerThread* keeper = GetWorker(GetGroup(EWorkerGroup::Foreground).FirstWorkerIndex);
+		if (keeper->IsParked())
+		{
+			keeper->Poke();
+		}
+	}
+
+	bool JobSystem::IsWorkerThread(std::thread::id threadId)
+	{
+		if (!m_bWorkersStarted.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+		return m_WorkerMap.find(threadId) != m_WorkerMap.end();
+	}
+
+	WorkerThread* JobSystem::GetCurrentWorker()
+	{
+		WorkerThread* worker = WorkerThread::GetCurrent();
+		return worker && worker->GetJobSystem() == this ? worker : nullptr;
+	}
 
-}
 
+}
\ No newline at end of file
@@ -2,38 +2,141 @@
 #include "Threading/Thread.h"
 #include "Jobs/Task.h"
 #include "Jobs/TaskQueues.h"
+#include "Jobs/TimerWheel.h"
+#include "Jobs/TaskGraph.h"
+#include "Jobs/TaskLabelStats.h"
+#include "Jobs/SpinPolicy.h"
+#include "IO/AsyncFileIO.h"
+#include <array>
 #include <vector>
 #include <unordered_map>
 #include <memory>
 #include <atomic>
 #include <thread>
+#include <mutex>
+#include <chrono>
 #include <cassert>
 
 namespace SV
 {
 	class WorkerThread;
 
+	struct WorkerGroupConfig
+	{
+		int32_t ThreadCount = 0; // Tasks targeting an empty group run on the foreground group
+		uint64_t AffinityMask = 0; // 0 pins foreground workers to one core each and lets other groups float
+		EThreadPriority Priority = EThreadPriority::Normal;
+		bool bStealFromOtherGroups = false; // Idle workers of this group help other groups
+		int32_t SpareThreadCount = 0; // Parked workers activated while others are in blocking regions, caps oversubscription
+
+		bool bAdaptiveScaling = false; // Parks idle workers and wakes them as the queues fill up
+		int32_t MinActiveThreadCount = 1; // Lower bound while scaling, ThreadCount is the upper bound
+		std::chrono::microseconds IdleParkTime{ 2000 }; // Idle time without a successful steal before a worker parks
+		std::chrono::microseconds AffinityStealDelay{ 250 }; // Soft affinity tasks wait this long in a mailbox before others steal them
+
+		// Bounds the group's global queue and each worker's local queue, 0 is unbounded. Mailboxes stay unbounded
+		size_t QueueCapacity = 0;
+		EBackpressurePolicy BackpressurePolicy = EBackpressurePolicy::RunInline; // Producer behaviour at capacity
+	};
+
+	struct JobSystemStats
+	{
+		int32_t WorkerCount = 0;
+		int32_t SpareWorkerCount = 0;
+		int32_t BlockedWorkerCount = 0; // Workers inside blocking regions
+		int32_t ActiveSpareWorkerCount = 0;
+		int32_t PeakActiveSpareWorkerCount = 0;
+		int32_t ActiveWorkerCount = 0; // Regular workers that are not parked
+		int32_t ParkedWorkerCount = 0;
+
+		// Largest queue sizes seen, the local one is the maximum over the workers
+		size_t GlobalQueueHighWaterMark = 0;
+		size_t LocalQueueHighWaterMark = 0;
+		uint64_t BackpressureCount = 0; // Dispatches that found their queue at capacity
+
+		// Largest scratch and frame allocator usage in bytes, maximum over the workers
+		size_t ScratchHighWaterMark = 0;
+		size_t FrameHighWaterMark = 0;
+	};
+
+	// Deadline results since the previous ConsumeDeadlineStats call, usually one frame
+	struct DeadlineStats
+	{
+		uint32_t CompletedCount = 0;
+		uint32_t MissCount = 0;
+		std::chrono::microseconds MaxLateness{ 0 };
+	};
+
+	enum class EShutdownMode : uint8_t
+	{
+		Drain, // Runs queued tasks until the queues are empty or the drain timeout passes, then cancels the rest
+		Cancel // Abandons queued tasks without running them, tasks already running are finished
+	};
+
+	struct JobSystemConfig
+	{
+		std::array<WorkerGroupConfig, static_cast<size_t>(EWorkerGroup::Count)> Groups;
+		EAsyncIOBackend FileIOBackend = EAsyncIOBackend::Auto;
+		bool bLazyWorkerStartup = false; // Worker threads are created on the first dispatch instead of in Initialize
+		bool bVerbose = false; // Startup and shutdown logging
+		bool bCalibrateSpinning = true; // Runs SpinPolicy::Calibrate before the workers start, see SpinPolicy
+		bool bLabelStats = true; // Duration and queue latency histograms of labeled tasks, see TaskLabelStats
+
+		WorkerGroupConfig& operator[](EWorkerGroup group) { return Groups[static_cast<size_t>(group)]; }
+		const WorkerGroupConfig& operator[](EWorkerGroup group) const { return Groups[static_cast<size_t>(group)]; }
+
+		// Foreground thread count <= 0 is derived from the core count
+		static JobSystemConfig Default(int32_t numThreads = -1);
+	};
+
+	// Scheduler instance with its own workers, queues, timers and affinity. Several can run side by side, e.g. one per
+	// hosted simulation pinned to its own cores. Initialize/Shutdown manage the default instance used by tasks that
+	// don't name a scheduler and aren't launched from a worker of another one.
 	class JobSystem
 	{
 	public:
+		explicit JobSystem(const JobSystemConfig& config = JobSystemConfig::Default());
+		// Drains with the default timeout unless Stop was called
+		~JobSystem();
+
+		// Every event of a task dispatched to this instance is completed or abandoned before this returns
+		void Stop(EShutdownMode mode = EShutdownMode::Drain, std::chrono::milliseconds drainTimeout = std::chrono::milliseconds(1000));
+
+		// The default instance
 		static JobSystem& Get()
 		{
 			assert(s_Instance && "TaskDispatcher is not initialized!");
 			return *s_Instance;
 		}
 
+		// The default instance, null if not initialized
+		static JobSystem* TryGet() { return s_Instance; }
+
+		// Instance owning the calling worker thread, null on other threads
+		static JobSystem* GetCurrentInstance();
+		// Instance owning the calling worker, the default instance on other threads
+		static JobSystem& GetCurrent()
+		{
+			JobSystem* instance = GetCurrentInstance();
+			return instance ? *instance : Get();
+		}
+
 		static void	Initialize(int32_t numThreads = -1)
+		{
+			Initialize(JobSystemConfig::Default(numThreads));
+		}
+
+		static void Initialize(const JobSystemConfig& config)
 		{
 			assert(!s_Instance && "TaskDispatcher already initialized!");
-			s_Instance = new JobSystem();
-			s_Instance->Startup(numThreads);
+			s_Instance = new JobSystem(config);
 		}
 
-		static void Shutdown()
+		static void Shutdown(EShutdownMode mode = EShutdownMode::Drain, std::chrono::milliseconds drainTimeout = std::chrono::milliseconds(1000))
 		{
 			if (s_Instance)
 			{
-				s_Instance->RequestShutdown();
+				s_Instance->Stop(mode, drainTimeout);
 				delete s_Instance;
 				s_Instance = nullptr;
 			}
@@ -41,22 +144,121 @@ namespace SV
 
 		// Used by workers
 		void DispatchTask(std::shared_ptr<JobTask> task);
-		std::shared_ptr<JobTask> PopGlobalQueue();
+		// Called once a dispatched task has finished or was abandoned
+		void OnTaskRetired() { m_InFlightTaskCount.fetch_sub(1, std::memory_order_acq_rel); }
+		// Set during shutdown, workers abandon the tasks they pop instead of running them
+		bool IsCancellingTasks() const { return m_bCancellingTasks.load(std::memory_order_acquire); }
+		std::shared_ptr<JobTask> PopGlobalQueue(EWorkerGroup group);
 		std::shared_ptr<JobTask> StealTaskFor(int32_t thiefId);
+		// Earliest deadline over the worker's own queue, its group queue and its steal victims
+		std::shared_ptr<JobTask> PopEarliestDeadlineTask(int32_t workerId);
+		// Worker index the affinity hints of the task resolve to, -1 if none
+		int32_t ResolveAffinityWorker(const JobTask& task);
+		bool HasQueuedDeadlineTasks() const { return m_QueuedDeadlineTaskCount.load(std::memory_order_relaxed) > 0; }
+		// bQueued is false for tasks run inline as a continuation, they never entered a queue
+		void RecordDeadlineTaskCompleted(const JobTask& task, std::chrono::steady_clock::time_point completionTime, bool bQueued);
+
+		// Call once per frame, resets the counters
+		DeadlineStats ConsumeDeadlineStats();
+		// Frees the frame allocators of every worker, see TaskMemory. Call once the tasks of the previous frame are done,
+		// each worker resets its allocator on first use in the new frame
+		void BeginFrame() { m_FrameIndex.fetch_add(1, std::memory_order_release); }
+		uint64_t GetFrameIndex() const { return m_FrameIndex.load(std::memory_order_acquire); }
+
+		int32_t GetWorkerCount(EWorkerGroup group) const { return GetGroup(group).WorkerCount; }
+
+		// Called through ScopedBlockingRegion, no-op on non-worker threads
+		void EnterBlockingRegion();
+		void LeaveBlockingRegion();
+
+		// Manual override, workers above the count park once idle. Adaptive scaling stays pinned to the count
+		void SetActiveWorkerCount(EWorkerGroup group, int32_t count);
+		// Range used by adaptive scaling, clamped to [0, ThreadCount] with at least one worker allowed
+		void SetActiveWorkerBounds(EWorkerGroup group, int32_t minCount, int32_t maxCount);
+		int32_t GetActiveWorkerCount(EWorkerGroup group) const { return GetGroup(group).ActiveWorkerCount.load(std::memory_order_relaxed); }
+
+		// Used by workers. Searching workers are idle but not parked
+		void SetWorkerSearching(const WorkerThread& worker, bool bSearching);
+		bool TryParkWorker(WorkerThread& worker, std::chrono::steady_clock::duration idleTime);
+		bool IsTimerKeeper(int32_t workerId) const { return workerId == GetGroup(EWorkerGroup::Foreground).FirstWorkerIndex; }
+
+		JobSystemStats GetStats(EWorkerGroup group) const;
+		JobSystemStats GetStats() const; // Summed over all groups
+
+		// Dispatches expired timers, called by idle workers
+		void ServiceTimers();
+		// Wakes the timer keeper if it is parked, called when a timer is scheduled
+		void WakeTimerKeeper();
+		TimerWheel& GetTimerWheel() { return m_TimerWheel; }
+		// Begin and End a capture of the runtime task graph, see AnalyzeTaskGraph
+		TaskGraphRecorder& GetGraphRecorder() { return m_GraphRecorder; }
+		// Null if disabled in the config
+		TaskLabelStats* GetLabelStats() { return m_LabelStats.get(); }
+		// Whether RecordTaskExecution needs the start and end times of the task
+		bool IsTaskTimed(const JobTask& task) const { return task.GetTraceId() != 0 || (task.GetParams().Label && m_LabelStats); }
+		// Feeds the graph capture and the label stats, workerId -1 for threads outside the workers
+		void RecordTaskExecution(const JobTask& task, int32_t workerId, std::chrono::steady_clock::time_point startTime, std::chrono::steady_clock::time_point endTime);
+		AsyncFileIO& GetFileIO() { return *m_FileIO; }
 
 		bool IsWorkerThread(std::thread::id threadId);
+		// Null unless called from a worker of this instance
 		WorkerThread* GetCurrentWorker();
-		void WorkerThreadReady();
+		// Creates the worker threads if lazy startup deferred them
+		void EnsureWorkersStarted();
 
 	private:
-		void Startup(int32_t numThreads);
-		void RequestShutdown();
-		int32_t DetermineWorkerThreadCount(int32_t requestedCount) const;
+		friend struct JobSystemConfig;
 
+		struct WorkerGroup
+		{
+			WorkerGroupConfig Config;
+			TaskGlobalQueue GlobalQueue;
+			int32_t FirstWorkerIndex = 0;
+			int32_t WorkerCount = 0;
+			int32_t SpareCount = 0; // Spares follow the regular workers
+
+			std::atomic<int32_t> BlockedCount{ 0 };
+			std::atomic<int32_t> ActiveSpareCount{ 0 };
+			std::atomic<int32_t> PeakActiveSpareCount{ 0 };
+
+			// Scaling of the regular workers, parking and unparking happens under the mutex
+			std::mutex ScalingMutex;
+			std::atomic<int32_t> MinActiveCount{ 0 };
+			std::atomic<int32_t> MaxActiveCount{ 0 };
+			std::atomic<int32_t> ActiveWorkerCount{ 0 };
+			std::atomic<int32_t> ParkedCount{ 0 };
+			std::atomic<int32_t> SearchingCount{ 0 };
+
+			std::atomic<uint64_t> BackpressureCount{ 0 };
+		};
+
+		void Startup(const JobSystemConfig& config);
+		void StartWorkers();
+		// Queue is at capacity, applies the group's backpressure policy
+		void PushWithBackpressure(WorkerGroup& group, ITaskQueue& queue, std::shared_ptr<JobTask> task);
+		// Runs a dispatched task on the calling thread instead of queuing it
+		void RunTaskOnCaller(std::shared_ptr<JobTask> task);
+		void RequestShutdown(EShutdownMode mode, std::chrono::milliseconds drainTimeout);
+		void AbandonTimers();
+		void UnparkAllWorkers();
+		// Returns false if the deadline passed first
+		bool WaitForInFlightTasks(std::chrono::steady_clock::time_point deadline);
+		static int32_t DetermineWorkerThreadCount(int32_t requestedCount);
+
+		WorkerGroup& GetGroup(EWorkerGroup group) { return m_Groups[static_cast<size_t>(group)]; }
+		const WorkerGroup& GetGroup(EWorkerGroup group) const { return m_Groups[static_cast<size_t>(group)]; }
+		std::shared_ptr<JobTask> StealFromGroup(const WorkerGroup& group, int32_t thiefId);
+		WorkerThread* GetWorker(int32_t workerId);
+
+		// Wakes a parked worker when the pushed-to queue holds more tasks than searching workers can take
+		void WakeWorkerIfNeeded(WorkerGroup& group, size_t queueDepth);
+		// Caller holds the scaling mutex
+		bool UnparkWorker(WorkerGroup& group);
+		void UnparkWorker(WorkerGroup& group, WorkerThread& worker);
+		WorkerGroup& GetTargetGroup(const JobTask& task);
+		bool HasStealableWork(const WorkerGroup& group);
 
 
-		JobSystem() = default;
-		~JobSystem() = default;
 
 		JobSystem(const JobSystem&) = delete;
 		JobSystem& operator=(const JobSystem&) = delete;
@@ -66,12 +268,55 @@ namespace SV
 	private:
 		std::vector<std::unique_ptr<Thread>> m_WorkerHandles;
 		std::unordered_map<std::thread::id, WorkerThread*> m_WorkerMap;
-		TaskGlobalQueue m_GlobalQueue;
+		std::array<WorkerGroup, static_cast<size_t>(EWorkerGroup::Count)> m_Groups;
+		TimerWheel m_TimerWheel;
+		TaskGraphRecorder m_GraphRecorder;
+		std::unique_ptr<TaskLabelStats> m_LabelStats;
+		std::unique_ptr<AsyncFileIO> m_FileIO;
 
 		std::atomic<bool> m_ShutdownRequested{ false };
-		std::atomic<int32_t> m_ReadyWorkerCount{ 0 };
+		bool m_bStopped = false;
 		int32_t m_TotalWorkerCount{ 0 };
+		bool m_bVerbose = false;
+		bool m_bCalibrateSpinning = true;
+
+		std::once_flag m_StartWorkersFlag;
+		std::atomic<bool> m_bWorkersStarted{ false };
+		// Dispatched tasks not yet finished or abandoned, inline continuations are covered by the task they follow
+		std::atomic<int32_t> m_InFlightTaskCount{ 0 };
+		std::atomic<bool> m_bCancellingTasks{ false };
+
+		std::atomic<int32_t> m_QueuedDeadlineTaskCount{ 0 };
+		std::atomic<uint32_t> m_DeadlineCompletedCount{ 0 };
+		std::atomic<uint32_t> m_DeadlineMissCount{ 0 };
+		std::atomic<int64_t> m_DeadlineMaxLatenessUs{ 0 };
+		std::atomic<uint64_t> m_FrameIndex{ 0 };
 
 		static inline JobSystem* s_Instance = nullptr;
 	};
+
+	// Marks the calling worker as blocked in the OS, a spare worker keeps the group parallelism while it lasts
+	class ScopedBlockingRegion
+	{
+	public:
+		ScopedBlockingRegion()
+			: m_JobSystem(JobSystem::GetCurrentInstance())
+		{
+			if (m_JobSystem)
+			{
+				m_JobSystem->EnterBlockingRegion();
+			}
+		}
+		~ScopedBlockingRegion()
+		{
+			if (m_JobSystem)
+			{
+				m_JobSystem->LeaveBlockingRegion();
+			}
+		}
+		ScopedBlockingRegion(const ScopedBlockingRegion&) = delete;
+		ScopedBlockingRegion& operator=(const ScopedBlockingRegion&) = delete;
+	private:
+		JobSystem* m_JobSystem;
+	};
 }
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include "ParallelFor.h"
+#include "JobSystem.h"
+#include "TaskGroup.h"
+#include "Platform/Platform.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace SV
+{
+	namespace ParallelForPrivate
+	{
+		namespace
+		{
+			// A few chunks per worker lets fast workers take over from slow ones
+			constexpr size_t CHUNKS_PER_WORKER = 4;
+
+			size_t GetCacheLineSize()
+			{
+				static const size_t s_LineSize = Platform::GetCacheSize(Platform::ECacheLevel::LineSize);
+				return s_LineSize;
+			}
+
+			size_t GetDefaultChunkBytes()
+			{
+				static const size_t s_ChunkBytes = Platform::GetCacheSize(Platform::ECacheLevel::L1Data) / 2;
+				return s_ChunkBytes;
+			}
+
+			size_t GetHelperWorkerCount(const ParallelForParams& params)
+			{
+				JobSystem& jobSystem = params.Scheduler ? *params.Scheduler : JobSystem::GetCurrent();
+				EWorkerGroup group = params.Group;
+				int32_t workerCount = jobSystem.GetWorkerCount(group);
+				if (workerCount == 0)
+				{
+					workerCount = jobSystem.GetWorkerCount(EWorkerGroup::Foreground);
+				}
+				return static_cast<size_t>(workerCount);
+			}
+		}
+
+		size_t GetChunkGranularity(std::initializer_list<size_t> elementSizes)
+		{
+			const size_t lineSize = GetCacheLineSize();
+			size_t granularity = 1;
+			for (size_t elementSize : elementSizes)
+			{
+				// Elements until this stream is back on a line boundary
+				size_t elementsPerLine = std::lcm(lineSize, elementSize) / elementSize;
+				granularity = std::lcm(granularity, elementsPerLine);
+			}
+			return granularity;
+		}
+
+		size_t GetChunkElementCount(size_t count, size_t granularity, size_t bytesPerElement, const ParallelForParams& params)
+		{
+			const size_t chunkBytes = params.ChunkBytes > 0 ? params.ChunkBytes : GetDefaultChunkBytes();
+			const size_t cacheElements = std::max(granularity, chunkBytes / bytesPerElement / granularity * granularity);
+
+			// Smaller chunks than the cache allows when the range is too short to keep every worker busy
+			const size_t balancedChunkCount = GetHelperWorkerCount(params) * CHUNKS_PER_WORKER;
+			const size_t balancedElements = (count / balancedChunkCount + granularity - 1) / granularity * granularity;
+			return std::clamp(balancedElements, granularity, cacheElements);
+		}
+
+		void RunChunks(size_t chunkCount, const std::function<void(size_t)>& runChunk, const ParallelForParams& params)
+		{
+			std::atomic<size_t> nextChunk{ 0 };
+			auto takeChunks = [&nextChunk, &runChunk, chunkCount]()
+				{
+					for (size_t chunkIndex = nextChunk.fetch_add(1, std::memory_order_relaxed); chunkIndex < chunkCount;
+						chunkIndex = nextChunk.fetch_add(1, std::memory_order_relaxed))
+					{
+						runChunk(chunkIndex);
+					}
+				};
+
+			TaskParams taskParams;
+			taskParams.Group = params.Group;
+			taskParams.Label = params.Label;
+			taskParams.Scheduler = params.Scheduler;
+
+			// Consecutive chunks are taken in order, each helper streams through memory.
+			// Helpers nobody picked up by the time the caller is done find no chunks left and return right away
+			const size_t helperCount = std::min(chunkCount - 1, GetHelperWorkerCount(params));
+			TaskGroup helpers(ETaskSpawnMode::Queued, taskParams);
+			for (size_t i = 0; i < helperCount; ++i)
+			{
+				helpers.Spawn(takeChunks);
+			}
+
+			takeChunks();
+			helpers.Wait();
+		}
+	}
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include "Threading/ThreadTypes.h"
+#include "Core/AlignedAllocator.h"
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
+
+namespace SV
+{
+	class JobSystem;
+
+	struct ParallelForParams
+	{
+		EWorkerGroup Group = EWorkerGroup::Foreground;
+		// Bytes over all streams per chunk, 0 keeps a chunk within half the L1 data cache.
+		// Kernels making several passes over a chunk may go up to the L2 size instead
+		size_t ChunkBytes = 0;
+		const char* Label = nullptr;
+		JobSystem* Scheduler = nullptr; // See TaskParams::Scheduler
+	};
+
+	namespace ParallelForPrivate
+	{
+		// Smallest element count that ends on a cache line boundary in every stream
+		size_t GetChunkGranularity(std::initializer_list<size_t> elementSizes);
+		size_t GetChunkElementCount(size_t count, size_t granularity, size_t bytesPerElement, const ParallelForParams& params);
+		// Runs runChunk for every chunk index on up to one task per worker, the caller takes chunks as well
+		void RunChunks(size_t chunkCount, const std::function<void(size_t)>& runChunk, const ParallelForParams& params);
+	}
+
+	// Splits parallel SoA arrays into chunks whose boundaries fall on cache line multiples in every stream and calls
+	// body(streams + begin..., count) per chunk. With cache line aligned arrays (see AlignedArray) every chunk
+	// starts aligned, so SIMD kernels need no peel loop and neighbouring chunks never share an output line.
+	// Only the final chunk may end on a partial vector. Returns once all chunks are done.
+	template<typename Body, typename... Ts>
+	void ParallelForChunks(size_t count, const ParallelForParams& params, Body&& body, Ts*... streams)
+	{
+		static_assert(sizeof...(Ts) > 0, "ParallelForChunks needs at least one stream");
+		if (count == 0)
+		{
+			return;
+		}
+
+		const size_t granularity = ParallelForPrivate::GetChunkGranularity({ sizeof(Ts)... });
+		const size_t chunkElements = ParallelForPrivate::GetChunkElementCount(count, granularity, (sizeof(Ts) + ...), params);
+		const size_t chunkCount = (count + chunkElements - 1) / chunkElements;
+		if (chunkCount == 1)
+		{
+			body(streams..., count);
+			return;
+		}
+
+		ParallelForPrivate::RunChunks(chunkCount,
+			[&](size_t chunkIndex)
+			{
+				const size_t begin = chunkIndex * chunkElements;
+				const size_t end = begin + chunkElements < count ? begin + chunkElements : count;
+				body((streams + begin)..., end - begin);
+			}, params);
+	}
+
+	template<typename Body, typename... Ts>
+		requires (!std::is_same_v<std::decay_t<Body>, ParallelForParams>)
+	void ParallelForChunks(size_t count, Body&& body, Ts*... streams)
+	{
+		ParallelForChunks(count, ParallelForParams(), std::forward<Body>(body), streams...);
+	}
+}
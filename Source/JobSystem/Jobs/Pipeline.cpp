@@ -0,0 +1,183 @@
+#include "Pipeline.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace SV
+{
+	PipelineBase::PipelineBase(size_t maxTokens, const TaskParams& params)
+		: m_MaxTokens(std::max<size_t>(1, maxTokens))
+		, m_Params(params)
+		, m_Sequences(m_MaxTokens, 0)
+	{
+		if (!m_Params.Scheduler)
+		{
+			m_Params.Scheduler = &JobSystem::GetCurrent();
+		}
+	}
+
+	void PipelineBase::AddStage(EPipelineStageMode mode, std::function<void(size_t)>&& function)
+	{
+		std::unique_ptr<StageState> stage = std::make_unique<StageState>();
+		stage->Mode = mode;
+		stage->Function = std::move(function);
+		m_Stages.push_back(std::move(stage));
+	}
+
+	void PipelineBase::RunTokens()
+	{
+		assert(m_Input && "Pipeline has no input");
+
+		m_FreeTokens.resize(m_MaxTokens);
+		for (size_t token = 0; token < m_MaxTokens; ++token)
+		{
+			// Popped from the back, the first item gets the first slot
+			m_FreeTokens[token] = m_MaxTokens - 1 - token;
+		}
+		m_NextInputSequence = 0;
+		m_bInputRunning = false;
+		m_bInputDone = false;
+		for (std::unique_ptr<StageState>& stage : m_Stages)
+		{
+			stage->bBusy = false;
+			stage->NextSequence = 0;
+			stage->ParkedTokens.clear();
+		}
+		m_DoneEvent = std::make_shared<TaskEvent>();
+		m_ActiveTaskCount.store(1, std::memory_order_relaxed);
+
+		RunInput();
+		std::shared_ptr<TaskEvent> doneEvent = m_DoneEvent;
+		OnTaskDone();
+		doneEvent->Wait();
+	}
+
+	void PipelineBase::RunInput()
+	{
+		for (;;)
+		{
+			size_t token = NO_TOKEN;
+			{
+				ScopedAdaptiveLock lock(m_InputLock);
+				if (m_bInputRunning || m_bInputDone || m_FreeTokens.empty())
+				{
+					return;
+				}
+				m_bInputRunning = true;
+				token = m_FreeTokens.back();
+				m_FreeTokens.pop_back();
+			}
+
+			const bool bHasItem = m_Input(token);
+
+			bool bHasFreeTokens = false;
+			{
+				ScopedAdaptiveLock lock(m_InputLock);
+				m_bInputRunning = false;
+				if (!bHasItem)
+				{
+					m_bInputDone = true;
+					m_FreeTokens.push_back(token);
+					return;
+				}
+				m_Sequences[token] = m_NextInputSequence++;
+				bHasFreeTokens = !m_FreeTokens.empty();
+			}
+
+			// Another task reads the next item while this one carries the current one on
+			if (bHasFreeTokens)
+			{
+				DispatchTask([this]() { RunInput(); });
+			}
+			RunToken(token, 0, false);
+		}
+	}
+
+	void PipelineBase::RunToken(size_t token, size_t stageIndex, bool bEntered)
+	{
+		for (; stageIndex < m_Stages.size(); ++stageIndex, bEntered = false)
+		{
+			StageState& stage = *m_Stages[stageIndex];
+			if (stage.Mode == EPipelineStageMode::Parallel)
+			{
+				stage.Function(token);
+				continue;
+			}
+
+			if (!bEntered && !TryEnterSerial(stage, token))
+			{
+				return;
+			}
+			stage.Function(token);
+			const size_t nextToken = LeaveSerial(stage);
+			if (nextToken != NO_TOKEN)
+			{
+				// This item stays on its thread, the parked one moves on from here in a new task
+				DispatchTask([this, nextToken, stageIndex]() { RunToken(nextToken, stageIndex, true); RunInput(); });
+			}
+		}
+		ReleaseToken(token);
+	}
+
+	bool PipelineBase::TryEnterSerial(StageState& stage, size_t token)
+	{
+		ScopedAdaptiveLock lock(stage.Lock);
+		if (!stage.bBusy && (stage.Mode == EPipelineStageMode::SerialOutOfOrder || m_Sequences[token] == stage.NextSequence))
+		{
+			stage.bBusy = true;
+			return true;
+		}
+		stage.ParkedTokens.push_back(token);
+		return false;
+	}
+
+	size_t PipelineBase::LeaveSerial(StageState& stage)
+	{
+		ScopedAdaptiveLock lock(stage.Lock);
+		++stage.NextSequence;
+		auto it = stage.ParkedTokens.begin();
+		if (stage.Mode == EPipelineStageMode::SerialInOrder)
+		{
+			it = std::find_if(stage.ParkedTokens.begin(), stage.ParkedTokens.end(),
+				[this, &stage](size_t token) { return m_Sequences[token] == stage.NextSequence; });
+		}
+		if (it == stage.ParkedTokens.end())
+		{
+			stage.bBusy = false;
+			return NO_TOKEN;
+		}
+		// Handed over without releasing the stage
+		const size_t token = *it;
+		stage.ParkedTokens.erase(it);
+		return token;
+	}
+
+	void PipelineBase::ReleaseToken(size_t token)
+	{
+		ScopedAdaptiveLock lock(m_InputLock);
+		m_FreeTokens.push_back(token);
+	}
+
+	void PipelineBase::DispatchTask(JobTask::TaskFunction&& function)
+	{
+		m_ActiveTaskCount.fetch_add(1, std::memory_order_relaxed);
+		std::shared_ptr<JobTask> task = std::make_shared<JobTask>([this, function = std::move(function)]()
+			{
+				function();
+				OnTaskDone();
+			}, m_Params);
+		m_Params.Scheduler->DispatchTask(std::move(task));
+	}
+
+	void PipelineBase::OnTaskDone()
+	{
+		// Every parked item has a task ahead of it in its stage and a free token always has a task heading for the
+		// input, so no tasks left means the pipeline is drained
+		std::shared_ptr<TaskEvent> doneEvent = m_DoneEvent;
+		if (m_ActiveTaskCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			doneEvent->Complete();
+		}
+	}
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include "Core/Defines.h"
+#include "Jobs/Task.h"
+#include "Threading/Synchronization.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace SV
+{
+	enum class EPipelineStageMode : uint8_t
+	{
+		SerialInOrder, // One item at a time, in the order the input produced them
+		SerialOutOfOrder, // One item at a time, in any order
+		Parallel // Any number of items at once
+	};
+
+	// Type independent part of Pipeline, stages work on token indices
+	class PipelineBase
+	{
+		NONCOPYABLE_NONMOVABLE(PipelineBase);
+	protected:
+		PipelineBase(size_t maxTokens, const TaskParams& params);
+		~PipelineBase() = default;
+
+		void SetInput(std::function<bool(size_t)>&& input) { m_Input = std::move(input); }
+		void AddStage(EPipelineStageMode mode, std::function<void(size_t)>&& function);
+		void RunTokens();
+		// At least one, even if constructed with 0
+		size_t GetMaxTokens() const { return m_MaxTokens; }
+
+	private:
+		static constexpr size_t NO_TOKEN = ~size_t(0);
+
+		struct StageState
+		{
+			EPipelineStageMode Mode;
+			std::function<void(size_t)> Function;
+
+			// Serial stages only
+			AdaptiveLock Lock;
+			bool bBusy = false;
+			uint64_t NextSequence = 0; // In order stages take items strictly by sequence
+			std::vector<size_t> ParkedTokens; // Arrived while the stage was busy or out of turn
+		};
+
+		// Reads items while tokens are free and no other thread reads the input, carrying each through the stages
+		void RunInput();
+		// bEntered if the serial stage was handed over by the token leaving it
+		void RunToken(size_t token, size_t stageIndex, bool bEntered);
+		bool TryEnterSerial(StageState& stage, size_t token);
+		// Returns the parked token that now owns the stage, if any
+		size_t LeaveSerial(StageState& stage);
+		void ReleaseToken(size_t token);
+
+		void DispatchTask(JobTask::TaskFunction&& function);
+		void OnTaskDone();
+
+	private:
+		const size_t m_MaxTokens;
+		TaskParams m_Params;
+		std::function<bool(size_t)> m_Input;
+		std::vector<std::unique_ptr<StageState>> m_Stages;
+		std::vector<uint64_t> m_Sequences; // Per token, set when the input fills it
+
+		AdaptiveLock m_InputLock; // Guards the input state and the free tokens
+		std::vector<size_t> m_FreeTokens;
+		uint64_t m_NextInputSequence = 0;
+		bool m_bInputRunning = false;
+		bool m_bInputDone = false;
+
+		// Pipeline tasks still running, plus one for the thread in Run. The last one completes m_DoneEvent
+		std::atomic<int32_t> m_ActiveTaskCount{ 0 };
+		std::shared_ptr<TaskEvent> m_DoneEvent;
+	};
+
+	// Streams items through a fixed sequence of stages on the workers, like a parallel_pipeline. At most maxTokens
+	// items are in flight, each in its own slot that is reused for later items, so memory stays bounded and buffers
+	// inside the item are recycled. A task carries its item through as many stages as it can, an item reaching a busy
+	// serial stage is parked and resumed by whichever item leaves that stage.
+	// Usage: Pipeline<Block>(8).Input(read).Stage(Parallel, decompress).Stage(SerialInOrder, write).Run();
+	template<typename T>
+	class Pipeline : private PipelineBase
+	{
+	public:
+		explicit Pipeline(size_t maxTokens, const TaskParams& params = TaskParams())
+			: PipelineBase(maxTokens, params)
+			, m_Items(GetMaxTokens())
+		{}
+
+		// Fills the slot with the next item, returns false once the stream ended. Runs serially in order.
+		// The slot still holds what the previous item left in it
+		Pipeline& Input(std::function<bool(T&)>&& input)
+		{
+			SetInput([this, input = std::move(input)](size_t token) { return input(m_Items[token]); });
+			return *this;
+		}
+
+		Pipeline& Stage(EPipelineStageMode mode, std::function<void(T&)>&& stage)
+		{
+			AddStage(mode, [this, stage = std::move(stage)](size_t token) { stage(m_Items[token]); });
+			return *this;
+		}
+
+		// Returns once the input ended and every item left the last stage. The calling thread takes part,
+		// must not overlap shutdown
+		void Run() { RunTokens(); }
+
+	private:
+		std::vector<T> m_Items;
+	};
+}
@@ -0,0 +1,233 @@
+#include "ResourceScheduler.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace SV
+{
+	class ResourceScheduler::ValidationScope
+	{
+	public:
+		ValidationScope(ResourceScheduler* scheduler, const std::vector<ResourceAccess>& accesses)
+			: m_Scheduler(scheduler)
+			, m_Accesses(accesses)
+			, m_Parent(s_Current)
+		{
+			m_Scheduler->BeginValidatedTask(m_Accesses);
+			s_Current = this;
+		}
+
+		~ValidationScope()
+		{
+			s_Current = m_Parent;
+			m_Scheduler->EndValidatedTask(m_Accesses);
+		}
+
+		ValidationScope(const ValidationScope&) = delete;
+		ValidationScope& operator=(const ValidationScope&) = delete;
+
+		static ValidationScope* GetCurrent() { return s_Current; }
+
+		ResourceScheduler* GetScheduler() const { return m_Scheduler; }
+		const std::vector<ResourceAccess>& GetAccesses() const { return m_Accesses; }
+
+	private:
+		ResourceScheduler* m_Scheduler;
+		const std::vector<ResourceAccess>& m_Accesses;
+		ValidationScope* m_Parent;
+
+		static inline thread_local ValidationScope* s_Current = nullptr;
+	};
+
+	ResourceScheduler::ResourceScheduler()
+#ifdef NDEBUG
+		: m_bValidationEnabled(false)
+#else
+		: m_bValidationEnabled(true)
+#endif
+	{
+	}
+
+	std::shared_ptr<TaskEvent> ResourceScheduler::Dispatch(
+		JobTask::TaskFunction&& function,
+		const std::vector<ResourceAccess>& accesses,
+		const std::vector<std::shared_ptr<TaskEvent>>& prerequisites /*= {}*/)
+	{
+		std::vector<ResourceAccess> merged = MergeAccesses(accesses);
+
+		std::shared_ptr<JobTask> task;
+		if (IsValidationEnabled())
+		{
+			task = std::make_shared<JobTask>(
+				[this, merged, function = std::move(function)]()
+				{
+					ValidationScope scope(this, merged);
+					function();
+				});
+		}
+		else
+		{
+			task = std::make_shared<JobTask>(std::move(function));
+		}
+
+		// Event has to exist before the task is dispatched, later tasks may depend on it right away
+		std::shared_ptr<TaskEvent> taskEvent = std::make_shared<TaskEvent>();
+		task->SetEvent(taskEvent);
+
+		std::vector<std::shared_ptr<TaskEvent>> allPrerequisites = prerequisites;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			for (const ResourceAccess& access : merged)
+			{
+				ResourceState& state = m_Resources[access.Resource];
+				std::erase_if(state.Readers, [](const std::shared_ptr<TaskEvent>& reader) { return reader->IsComplete(); });
+				if (state.LastWriter && state.LastWriter->IsComplete())
+				{
+					state.LastWriter = nullptr;
+				}
+
+				if (access.Access == EResourceAccess::Write)
+				{
+					if (!state.Readers.empty())
+					{
+						// WAR, readers already depend on the last writer
+						allPrerequisites.insert(allPrerequisites.end(), state.Readers.begin(), state.Readers.end());
+					}
+					else if (state.LastWriter)
+					{
+						// WAW
+						allPrerequisites.push_back(state.LastWriter);
+					}
+					state.Readers.clear();
+					state.LastWriter = taskEvent;
+				}
+				else
+				{
+					// RAW
+					if (state.LastWriter)
+					{
+						allPrerequisites.push_back(state.LastWriter);
+					}
+					state.Readers.push_back(taskEvent);
+				}
+			}
+		}
+
+		return JobTask::Launch(std::move(task), allPrerequisites);
+	}
+
+	void ResourceScheduler::Reset()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Resources.clear();
+	}
+
+	void ResourceScheduler::ReportAccess(ResourceId resource, EResourceAccess access)
+	{
+		ValidationScope* scope = ValidationScope::GetCurrent();
+		if (scope)
+		{
+			scope->GetScheduler()->ValidateAccess(scope->GetAccesses(), resource, access);
+		}
+	}
+
+	void ResourceScheduler::BeginValidatedTask(const std::vector<ResourceAccess>& accesses)
+	{
+		std::lock_guard<std::mutex> lock(m_ValidationMutex);
+		for (const ResourceAccess& access : accesses)
+		{
+			ActiveAccess& active = m_ActiveAccesses[access.Resource];
+			bool bConflict = access.Access == EResourceAccess::Write
+				? (active.Readers > 0 || active.Writers > 0)
+				: active.Writers > 0;
+			if (bConflict)
+			{
+				// Dependencies were inferred incorrectly or a task bypassed the scheduler
+				m_ViolationCount.fetch_add(1, std::memory_order_relaxed);
+				std::cout << "[ResourceScheduler] Conflicting declared access to resource " << access.Resource << "\n";
+			}
+
+			if (access.Access == EResourceAccess::Write)
+			{
+				active.Writers++;
+			}
+			else
+			{
+				active.Readers++;
+			}
+		}
+	}
+
+	void ResourceScheduler::EndValidatedTask(const std::vector<ResourceAccess>& accesses)
+	{
+		std::lock_guard<std::mutex> lock(m_ValidationMutex);
+		for (const ResourceAccess& access : accesses)
+		{
+			auto it = m_ActiveAccesses.find(access.Resource);
+			if (it == m_ActiveAccesses.end())
+			{
+				continue;
+			}
+
+			if (access.Access == EResourceAccess::Write)
+			{
+				it->second.Writers--;
+			}
+			else
+			{
+				it->second.Readers--;
+			}
+
+			if (it->second.Readers == 0 && it->second.Writers == 0)
+			{
+				m_ActiveAccesses.erase(it);
+			}
+		}
+	}
+
+	void ResourceScheduler::ValidateAccess(const std::vector<ResourceAccess>& declared, ResourceId resource, EResourceAccess access)
+	{
+		auto it = std::find_if(declared.begin(), declared.end(), [resource](const ResourceAccess& entry) { return entry.Resource == resource; });
+		bool bDeclared = it != declared.end() && (access == EResourceAccess::Read || it->Access == EResourceAccess::Write);
+		if (bDeclared)
+		{
+			return;
+		}
+
+		// Any undeclared access is a potential race, report whether another task currently holds the resource
+		bool bConflict = false;
+		{
+			std::lock_guard<std::mutex> lock(m_ValidationMutex);
+			auto activeIt = m_ActiveAccesses.find(resource);
+			if (activeIt != m_ActiveAccesses.end())
+			{
+				int32_t otherReaders = activeIt->second.Readers - (it != declared.end() ? 1 : 0);
+				bConflict = activeIt->second.Writers > 0 || (access == EResourceAccess::Write && otherReaders > 0);
+			}
+		}
+
+		m_ViolationCount.fetch_add(1, std::memory_order_relaxed);
+		std::cout << "[ResourceScheduler] Undeclared " << (access == EResourceAccess::Write ? "write" : "read")
+			<< " of resource " << resource << (bConflict ? " while in use by another task" : "") << "\n";
+	}
+
+	std::vector<ResourceAccess> ResourceScheduler::MergeAccesses(const std::vector<ResourceAccess>& accesses)
+	{
+		// One entry per resource, write wins over read
+		std::vector<ResourceAccess> merged;
+		merged.reserve(accesses.size());
+		for (const ResourceAccess& access : accesses)
+		{
+			auto it = std::find_if(merged.begin(), merged.end(), [&access](const ResourceAccess& entry) { return entry.Resource == access.Resource; });
+			if (it == merged.end())
+			{
+				merged.push_back(access);
+			}
+			else if (access.Access == EResourceAccess::Write)
+			{
+				it->Access = EResourceAccess::Write;
+			}
+		}
+		return merged;
+	}
+}
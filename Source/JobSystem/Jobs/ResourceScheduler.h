@@ -0,0 +1,94 @@
+#pragma once
+#include "Core/Defines.h"
+#include "Jobs/Task.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace SV
+{
+	using ResourceId = uint64_t;
+
+	template<typename T>
+	ResourceId MakeResourceId(const T* resource)
+	{
+		return static_cast<ResourceId>(reinterpret_cast<uintptr_t>(resource));
+	}
+
+	enum class EResourceAccess : uint8_t
+	{
+		Read,
+		Write
+	};
+
+	struct ResourceAccess
+	{
+		ResourceId Resource;
+		EResourceAccess Access;
+
+		static ResourceAccess Read(ResourceId resource) { return { resource, EResourceAccess::Read }; }
+		static ResourceAccess Write(ResourceId resource) { return { resource, EResourceAccess::Write }; }
+	};
+
+	// Infers task prerequisites from declared resource accesses in dispatch order.
+	// Readers depend on the last writer (RAW), a writer depends on all readers since the last write (WAR)
+	// or on the last writer itself (WAW). Readers of the same resource run concurrently.
+	class ResourceScheduler
+	{
+		NONCOPYABLE_NONMOVABLE(ResourceScheduler);
+	public:
+		ResourceScheduler();
+		~ResourceScheduler() = default;
+
+		std::shared_ptr<TaskEvent> Dispatch(
+			JobTask::TaskFunction&& function,
+			const std::vector<ResourceAccess>& accesses,
+			const std::vector<std::shared_ptr<TaskEvent>>& prerequisites = {});
+
+		// Forget access history, e.g. at frame boundaries. Already dispatched tasks keep their dependencies
+		void Reset();
+
+		// Debug mode: task bodies report actual accesses, undeclared ones are logged
+		void SetValidationEnabled(bool bEnabled) { m_bValidationEnabled.store(bEnabled, std::memory_order_relaxed); }
+		bool IsValidationEnabled() const { return m_bValidationEnabled.load(std::memory_order_relaxed); }
+		uint32_t GetViolationCount() const { return m_ViolationCount.load(std::memory_order_relaxed); }
+
+		// Called from task bodies, no-op outside of validated tasks
+		static void ReportAccess(ResourceId resource, EResourceAccess access);
+
+	private:
+		struct ResourceState
+		{
+			std::shared_ptr<TaskEvent> LastWriter;
+			std::vector<std::shared_ptr<TaskEvent>> Readers; // Since the last write
+		};
+
+		// Declared accesses of currently running tasks, validation only
+		struct ActiveAccess
+		{
+			int32_t Readers = 0;
+			int32_t Writers = 0;
+		};
+
+		class ValidationScope;
+
+		void BeginValidatedTask(const std::vector<ResourceAccess>& accesses);
+		void EndValidatedTask(const std::vector<ResourceAccess>& accesses);
+		void ValidateAccess(const std::vector<ResourceAccess>& declared, ResourceId resource, EResourceAccess access);
+
+		static std::vector<ResourceAccess> MergeAccesses(const std::vector<ResourceAccess>& accesses);
+
+	private:
+		std::unordered_map<ResourceId, ResourceState> m_Resources;
+		std::mutex m_Mutex;
+
+		std::unordered_map<ResourceId, ActiveAccess> m_ActiveAccesses;
+		std::mutex m_ValidationMutex;
+		std::atomic<bool> m_bValidationEnabled;
+		std::atomic<uint32_t> m_ViolationCount{ 0 };
+	};
+}
@@ -0,0 +1,259 @@
+#include "SpinPolicy.h"
+#include "Platform/Platform.h"
+
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace SV
+{
+	namespace
+	{
+		constexpr uint32_t MIN_IDLE_SPINS = 16;
+		constexpr uint32_t MAX_IDLE_SPINS = 4096;
+		constexpr uint32_t MIN_WAIT_SPINS = 32;
+		constexpr uint32_t MAX_WAIT_SPINS = 16384;
+		constexpr std::chrono::microseconds MIN_WORKER_WAIT_SLICE{ 50 };
+		constexpr std::chrono::microseconds MAX_WORKER_WAIT_SLICE{ 1000 };
+		// Sleeping should cost a worker at most a few percent of the slice in wakeups
+		constexpr int32_t WAKE_LATENCIES_PER_SLICE = 20;
+
+		constexpr int32_t PAUSE_RUNS = 5;
+		constexpr int32_t PAUSES_PER_RUN = 1000;
+		constexpr int32_t WAKE_ROUNDS = 16;
+		constexpr int32_t PING_PONG_ROUNDS = 1000;
+
+		struct SpinPolicyState
+		{
+			std::mutex Mutex; // Guards Settings, budgets and the slice are read without it
+			SpinSettings Settings;
+			bool bFixed = false;
+			std::once_flag CalibrateFlag;
+			std::atomic<int64_t> WorkerWaitSliceUs{ SpinSettings().WorkerWaitSlice.count() };
+		};
+
+		SpinPolicyState& GetState()
+		{
+			static SpinPolicyState s_State;
+			return s_State;
+		}
+
+		std::chrono::nanoseconds MeasurePauseCost()
+		{
+			std::chrono::nanoseconds best = std::chrono::nanoseconds::max();
+			for (int32_t run = 0; run < PAUSE_RUNS; ++run)
+			{
+				const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+				for (int32_t i = 0; i < PAUSES_PER_RUN; ++i)
+				{
+					Platform::CpuPause();
+				}
+				best = std::min(best, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start));
+			}
+			return std::max(std::chrono::nanoseconds(1), best / PAUSES_PER_RUN);
+		}
+
+		int64_t NowNs()
+		{
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+		// Median wake latency of a partner thread sleeping on a futex, then the ping-pong round trip with it
+		void MeasureThreadCosts(SpinSettings& settings, bool bMultiCore)
+		{
+			std::atomic<uint32_t> wakeRound{ 0 };
+			std::atomic<uint32_t> sleepingRound{ 0 };
+			std::atomic<int64_t> wakeTimeNs{ 0 };
+			std::vector<int64_t> latenciesNs(WAKE_ROUNDS, 0);
+			std::atomic<uint32_t> ping{ 0 };
+			std::atomic<uint32_t> pong{ 0 };
+
+			std::thread partner([&]()
+				{
+					for (uint32_t round = 0; round < WAKE_ROUNDS; ++round)
+					{
+						sleepingRound.store(round + 1, std::memory_order_release);
+						while (wakeRound.load(std::memory_order_acquire) == round)
+						{
+							Platform::WaitOnAddress(wakeRound, round);
+						}
+						latenciesNs[round] = NowNs() - wakeTimeNs.load(std::memory_order_relaxed);
+					}
+					for (uint32_t round = 1; bMultiCore && round <= PING_PONG_ROUNDS; ++round)
+					{
+						while (ping.load(std::memory_order_acquire) != round)
+						{
+							Platform::CpuPause();
+						}
+						pong.store(round, std::memory_order_release);
+					}
+				});
+
+			for (uint32_t round = 0; round < WAKE_ROUNDS; ++round)
+			{
+				while (sleepingRound.load(std::memory_order_acquire) != round + 1)
+				{
+					std::this_thread::yield();
+				}
+				// Gives the partner time to actually fall asleep
+				std::this_thread::sleep_for(std::chrono::microseconds(200));
+				wakeTimeNs.store(NowNs(), std::memory_order_relaxed);
+				wakeRound.store(round + 1, std::memory_order_release);
+				Platform::WakeAllOnAddress(wakeRound);
+			}
+
+			if (bMultiCore)
+			{
+				const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+				for (uint32_t round = 1; round <= PING_PONG_ROUNDS; ++round)
+				{
+					ping.store(round, std::memory_order_release);
+					while (pong.load(std::memory_order_acquire) != round)
+					{
+						Platform::CpuPause();
+					}
+				}
+				settings.StealRoundTrip = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start) / PING_PONG_ROUNDS;
+			}
+			partner.join();
+
+			std::nth_element(latenciesNs.begin(), latenciesNs.begin() + WAKE_ROUNDS / 2, latenciesNs.end());
+			settings.WakeLatency = std::chrono::nanoseconds(std::max<int64_t>(1, latenciesNs[WAKE_ROUNDS / 2]));
+		}
+
+		void ApplyBudgets(const SpinSettings& settings)
+		{
+			SpinPolicy::GetIdleBudget().Set(settings.IdleSpinCount, settings.bAdaptive);
+			SpinPolicy::GetWaitBudget().Set(settings.WaitSpinCount, settings.bAdaptive);
+			GetState().WorkerWaitSliceUs.store(settings.WorkerWaitSlice.count(), std::memory_order_relaxed);
+		}
+	}
+
+	void AdaptiveSpinBudget::Set(uint32_t budget, bool bAdaptive)
+	{
+		m_Budget.store(budget, std::memory_order_relaxed);
+		m_bAdaptive.store(bAdaptive, std::memory_order_relaxed);
+	}
+
+	void AdaptiveSpinBudget::RecordOutcome(uint32_t spinCount, bool bFound)
+	{
+		if (!m_bAdaptive.load(std::memory_order_relaxed))
+		{
+			return;
+		}
+		const uint32_t budget = Get();
+		if (bFound && spinCount < budget)
+		{
+			m_HitCount.fetch_add(1, std::memory_order_relaxed);
+		}
+		// Last quarter of the budget or just past it, a longer budget would have caught these early. Work found much
+		// later would not have been caught by doubling the budget either
+		if (bFound && spinCount >= budget - budget / 4 && spinCount <= budget + budget / 4)
+		{
+			m_LateHitCount.fetch_add(1, std::memory_order_relaxed);
+		}
+		if (m_SampleCount.fetch_add(1, std::memory_order_relaxed) + 1 == WINDOW_SIZE)
+		{
+			Adjust();
+		}
+	}
+
+	void AdaptiveSpinBudget::Adjust()
+	{
+		// Samples racing with the reset are dropped, the next window has plenty
+		m_SampleCount.store(0, std::memory_order_relaxed);
+		const uint32_t hitCount = m_HitCount.exchange(0, std::memory_order_relaxed);
+		const uint32_t lateHitCount = m_LateHitCount.exchange(0, std::memory_order_relaxed);
+
+		const uint32_t budget = Get();
+		if (lateHitCount * 8 >= WINDOW_SIZE)
+		{
+			m_Budget.store(std::min(m_MaxBudget, budget * 2), std::memory_order_relaxed);
+		}
+		else if (hitCount * 8 < WINDOW_SIZE)
+		{
+			m_Budget.store(std::max(m_MinBudget, budget - budget / 4), std::memory_order_relaxed);
+		}
+	}
+
+	void SpinPolicy::Calibrate()
+	{
+		SpinPolicyState& state = GetState();
+		std::call_once(state.CalibrateFlag, [&state]()
+			{
+				SpinSettings measured;
+				const bool bMultiCore = Platform::GetLogicalCoreCount() > 1;
+				measured.PauseCost = MeasurePauseCost();
+				MeasureThreadCosts(measured, bMultiCore);
+
+				if (bMultiCore)
+				{
+					// Spinning about as long as sleeping and waking up would take wastes at most half of the time spent
+					const std::chrono::nanoseconds idleIterationCost = measured.PauseCost + measured.StealRoundTrip;
+					measured.IdleSpinCount = static_cast<uint32_t>(std::clamp<int64_t>(measured.WakeLatency / idleIterationCost, MIN_IDLE_SPINS, MAX_IDLE_SPINS));
+					measured.WaitSpinCount = static_cast<uint32_t>(std::clamp<int64_t>(measured.WakeLatency / measured.PauseCost, MIN_WAIT_SPINS, MAX_WAIT_SPINS));
+				}
+				else
+				{
+					// Nobody else makes progress while this core spins
+					measured.IdleSpinCount = MIN_IDLE_SPINS;
+					measured.WaitSpinCount = MIN_WAIT_SPINS;
+				}
+				measured.WorkerWaitSlice = std::clamp(std::chrono::duration_cast<std::chrono::microseconds>(measured.WakeLatency * WAKE_LATENCIES_PER_SLICE),
+					MIN_WORKER_WAIT_SLICE, MAX_WORKER_WAIT_SLICE);
+
+				std::lock_guard<std::mutex> lock(state.Mutex);
+				if (state.bFixed)
+				{
+					// Fixed budgets win, only the measurements are kept
+					state.Settings.PauseCost = measured.PauseCost;
+					state.Settings.WakeLatency = measured.WakeLatency;
+					state.Settings.StealRoundTrip = measured.StealRoundTrip;
+					return;
+				}
+				state.Settings = measured;
+				ApplyBudgets(measured);
+			});
+	}
+
+	void SpinPolicy::SetFixed(const SpinSettings& settings)
+	{
+		SpinPolicyState& state = GetState();
+		std::lock_guard<std::mutex> lock(state.Mutex);
+		state.bFixed = true;
+		state.Settings.IdleSpinCount = settings.IdleSpinCount;
+		state.Settings.WaitSpinCount = settings.WaitSpinCount;
+		state.Settings.WorkerWaitSlice = settings.WorkerWaitSlice;
+		state.Settings.bAdaptive = false;
+		ApplyBudgets(state.Settings);
+	}
+
+	SpinSettings SpinPolicy::GetSettings()
+	{
+		SpinPolicyState& state = GetState();
+		std::lock_guard<std::mutex> lock(state.Mutex);
+		SpinSettings settings = state.Settings;
+		settings.IdleSpinCount = GetIdleBudget().Get();
+		settings.WaitSpinCount = GetWaitBudget().Get();
+		settings.WorkerWaitSlice = GetWorkerWaitSlice();
+		return settings;
+	}
+
+	AdaptiveSpinBudget& SpinPolicy::GetIdleBudget()
+	{
+		static AdaptiveSpinBudget s_IdleBudget(SpinSettings().IdleSpinCount, MIN_IDLE_SPINS, MAX_IDLE_SPINS);
+		return s_IdleBudget;
+	}
+
+	AdaptiveSpinBudget& SpinPolicy::GetWaitBudget()
+	{
+		static AdaptiveSpinBudget s_WaitBudget(SpinSettings().WaitSpinCount, MIN_WAIT_SPINS, MAX_WAIT_SPINS);
+		return s_WaitBudget;
+	}
+
+	std::chrono::microseconds SpinPolicy::GetWorkerWaitSlice()
+	{
+		return std::chrono::microseconds(GetState().WorkerWaitSliceUs.load(std::memory_order_relaxed));
+	}
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include "Core/Defines.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace SV
+{
+	// Spin budgets in use and the measurements they were derived from
+	struct SpinSettings
+	{
+		// Zero until calibrated, StealRoundTrip also stays zero on single core machines
+		std::chrono::nanoseconds PauseCost{ 0 };
+		std::chrono::nanoseconds WakeLatency{ 0 }; // From waking a sleeping thread until it runs
+		std::chrono::nanoseconds StealRoundTrip{ 0 }; // Cache line ping-pong between two threads, the floor of any steal
+
+		uint32_t IdleSpinCount = 256; // Idle worker loop iterations before it starts yielding towards parking
+		uint32_t WaitSpinCount = 1000; // Pauses before a blocking wait goes to sleep
+		std::chrono::microseconds WorkerWaitSlice{ 100 }; // How long a worker waiting inside a task sleeps before looking for tasks again
+		bool bAdaptive = true; // Budgets keep adjusting to how often spinning found work
+	};
+
+	// Spin budget adjusted in windows of outcomes. It grows while a good share of spins only succeed near or just
+	// past the end of the budget, and shrinks while spinning rarely finds anything before the thread sleeps
+	class AdaptiveSpinBudget
+	{
+	public:
+		AdaptiveSpinBudget(uint32_t budget, uint32_t minBudget, uint32_t maxBudget)
+			: m_Budget(budget)
+			, m_MinBudget(minBudget)
+			, m_MaxBudget(maxBudget)
+		{}
+
+		uint32_t Get() const { return m_Budget.load(std::memory_order_relaxed); }
+		void Set(uint32_t budget, bool bAdaptive);
+
+		// spinCount past the budget means the work showed up after spinning gave up but before the thread slept,
+		// callers report a miss once they are past the late window of a quarter budget
+		void RecordOutcome(uint32_t spinCount, bool bFound);
+
+	private:
+		void Adjust();
+
+	private:
+		static constexpr uint32_t WINDOW_SIZE = 256;
+
+		std::atomic<uint32_t> m_Budget;
+		const uint32_t m_MinBudget;
+		const uint32_t m_MaxBudget;
+		std::atomic<bool> m_bAdaptive{ true };
+
+		std::atomic<uint32_t> m_SampleCount{ 0 };
+		std::atomic<uint32_t> m_HitCount{ 0 };
+		std::atomic<uint32_t> m_LateHitCount{ 0 };
+	};
+
+	// Process wide, shared by all job system instances. Budgets start from the defaults above until calibrated
+	class SpinPolicy
+	{
+	public:
+		// Measures pause cost, wake latency and the steal round trip and derives the budgets from them.
+		// Runs once, takes a few milliseconds. Job systems call it before starting their first workers
+		static void Calibrate();
+		// Pins the budgets and stops adapting them, e.g. for reproducible benchmarks
+		static void SetFixed(const SpinSettings& settings);
+		static SpinSettings GetSettings();
+
+		// Idle worker loop
+		static AdaptiveSpinBudget& GetIdleBudget();
+		// TaskEvent waits and the task synchronization primitives
+		static AdaptiveSpinBudget& GetWaitBudget();
+		static std::chrono::microseconds GetWorkerWaitSlice();
+	};
+}
@@ -1,30 +1,79 @@
 #include "Task.h"
 #include "JobSystem.h"
+#include "WorkerThread.h"
+#include "SpinPolicy.h"
 #include "Threading/Synchronization.h"
+#include "Platform/Platform.h"
 #include <thread>
 #include <chrono>
+#include <algorithm>
 
 namespace SV
 {
+	// Single futex word shared by all events a thread waits on
+	class TaskEventWaiter
+	{
+	public:
+		explicit TaskEventWaiter(uint32_t requiredSignals)
+			: m_Remaining(requiredSignals)
+		{}
+
+		void Signal()
+		{
+			uint32_t remaining = m_Remaining.load(std::memory_order_acquire);
+			while (remaining > 0 && !m_Remaining.compare_exchange_weak(remaining, remaining - 1, std::memory_order_acq_rel))
+			{
+			}
+			if (remaining == 1)
+			{
+				Platform::WakeAllOnAddress(m_Remaining);
+			}
+		}
+
+		bool IsSignaled() const
+		{
+			return m_Remaining.load(std::memory_order_acquire) == 0;
+		}
+
+		void Wait(std::chrono::steady_clock::time_point deadline)
+		{
+			uint32_t remaining = m_Remaining.load(std::memory_order_acquire);
+			if (remaining > 0)
+			{
+				Platform::WaitOnAddress(m_Remaining, remaining, deadline);
+			}
+		}
 
-	void TaskEvent::AddSubsequent(std::shared_ptr<JobTask> task)
+	private:
+		std::atomic<uint32_t> m_Remaining;
+	};
+
+
+	JobSystem* JobTask::ResolveScheduler(JobSystem* scheduler)
+	{
+		if (scheduler)
+		{
+			return scheduler;
+		}
+		JobSystem* instance = JobSystem::GetCurrentInstance();
+		return instance ? instance : &JobSystem::Get();
+	}
+
+	bool TaskEvent::AddSubsequent(std::shared_ptr<JobTask> task)
 	{
-		ScopedSpinLock lock(m_Lock);
+		ScopedAdaptiveLock lock(m_Lock);
 
-		// If already completed, dispatch immediately
+		// Already completed, caller is responsible for dispatching
 		if (m_Completed.load(std::memory_order_acquire))
 		{
-			// Release lock before dispatching to avoid deadlock
-			lock.~ScopedSpinLock();
-			std::unique_ptr<JobTask> uniqueTask(task.get());
-			JobSystem::Get().DispatchTask(std::move(uniqueTask));
-			return;
+			return false;
 		}
 		task->IncrementPrerequisiteCount();
-		m_Subsequents.push_back(task);
+		m_Subsequents.push_back(std::move(task));
+		return true;
 	}
 
-	void TaskEvent::Complete()
+	void TaskEvent::Complete(std::shared_ptr<JobTask>* outContinuation /*= nullptr*/)
 	{
 		// Mark as completed
 		bool expected = false;
@@ -37,8 +86,15 @@ namespace SV
 		// Dispatch all dependent tasks
 		std::vector<std::shared_ptr<JobTask>> dependents;
 		{
-			ScopedSpinLock lock(m_Lock);
+			ScopedAdaptiveLock lock(m_Lock);
 			dependents = std::move(m_Subsequents);
+
+			// Signal under the lock so a timed out waiter can't unregister and go out of scope meanwhile
+			for (TaskEventWaiter* waiter : m_Waiters)
+			{
+				waiter->Signal();
+			}
+			m_Waiters.clear();
 		}
 
 		for (auto& task : dependents)
@@ -46,65 +102,250 @@ namespace SV
 			int32_t remainingPrereqs = task->DecrementPrerequisiteCount();
 			if (remainingPrereqs == 0)
 			{
-				JobSystem::Get().DispatchTask(task);
+				// First inlinable ready task is handed back to the completing worker instead of queued
+				if (outContinuation && !*outContinuation && task->CanRunInline())
+				{
+					if (task->GetScheduler().IsTaskTimed(*task))
+					{
+						task->MarkReady();
+					}
+					*outContinuation = std::move(task);
+					continue;
+				}
+				task->GetScheduler().DispatchTask(task);
 			}
 		}
 	}
 
+	bool TaskEvent::AddWaiter(TaskEventWaiter* waiter)
+	{
+		ScopedAdaptiveLock lock(m_Lock);
+		if (m_Completed.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+		m_Waiters.push_back(waiter);
+		return true;
+	}
+
+	void TaskEvent::RemoveWaiter(TaskEventWaiter* waiter)
+	{
+		ScopedAdaptiveLock lock(m_Lock);
+		auto it = std::find(m_Waiters.begin(), m_Waiters.end(), waiter);
+		if (it != m_Waiters.end())
+		{
+			*it = m_Waiters.back();
+			m_Waiters.pop_back();
+		}
+	}
+
 	void TaskEvent::Wait()
 	{
-		constexpr int32_t SPIN_COUNT = 1000;
-		int32_t spinCount = 0;
+		WaitUntil(std::chrono::steady_clock::time_point::max());
+	}
 
-		while (!IsComplete())
+	bool TaskEvent::WaitUntil(std::chrono::steady_clock::time_point deadline)
+	{
+		if (IsComplete())
 		{
-			if (spinCount++ < SPIN_COUNT)
+			return true;
+		}
+		std::shared_ptr<TaskEvent> self = shared_from_this();
+		return WaitInternal({ &self, 1 }, 1, deadline);
+	}
+
+	void TaskEvent::WaitAll(std::span<const std::shared_ptr<TaskEvent>> events)
+	{
+		WaitAllUntil(events, std::chrono::steady_clock::time_point::max());
+	}
+
+	bool TaskEvent::WaitAllUntil(std::span<const std::shared_ptr<TaskEvent>> events, std::chrono::steady_clock::time_point deadline)
+	{
+		return WaitInternal(events, static_cast<uint32_t>(events.size()), deadline);
+	}
+
+	int32_t TaskEvent::WaitAny(std::span<const std::shared_ptr<TaskEvent>> events)
+	{
+		return WaitAnyUntil(events, std::chrono::steady_clock::time_point::max());
+	}
+
+	int32_t TaskEvent::WaitAnyUntil(std::span<const std::shared_ptr<TaskEvent>> events, std::chrono::steady_clock::time_point deadline)
+	{
+		if (events.empty() || !WaitInternal(events, 1, deadline))
+		{
+			return -1;
+		}
+		for (size_t i = 0; i < events.size(); ++i)
+		{
+			if (!events[i] || events[i]->IsComplete())
 			{
-				#if defined(_MSC_VER)
-					_mm_pause();
-				#else
-					__builtin_ia32_pause();
-				#endif
+				return static_cast<int32_t>(i);
 			}
-			else
+		}
+		return -1;
+	}
+
+	bool TaskEvent::WaitInternal(std::span<const std::shared_ptr<TaskEvent>> events, uint32_t requiredCount, std::chrono::steady_clock::time_point deadline)
+	{
+		auto countCompleted = [events]()
 			{
-				// Yield to other threads
-				std::this_thread::sleep_for(std::chrono::microseconds(100));
-				spinCount = 0;
+				uint32_t completed = 0;
+				for (const auto& event : events)
+				{
+					if (!event || event->IsComplete())
+					{
+						completed++;
+					}
+				}
+				return completed;
+			};
+
+		// Workers keep executing queued tasks, the awaited task may be sitting in their own queue
+		WorkerThread* worker = WorkerThread::GetCurrent();
+
+		// Spin before paying for waiter registration
+		AdaptiveSpinBudget& spinBudget = SpinPolicy::GetWaitBudget();
+		const uint32_t maxSpinCount = spinBudget.Get();
+		uint32_t spinCount = 0;
+		while (countCompleted() < requiredCount)
+		{
+			if (std::chrono::steady_clock::now() >= deadline)
+			{
+				return false;
+			}
+			if (worker && worker->TryExecuteTask())
+			{
+				continue;
 			}
+			if (spinCount++ >= maxSpinCount)
+			{
+				break;
+			}
+			Platform::CpuPause();
 		}
-	}
 
+		const bool bCompletedSpinning = countCompleted() >= requiredCount;
+		// Waits done by helping alone say nothing about the budget
+		if (spinCount > 0)
+		{
+			spinBudget.RecordOutcome(spinCount, bCompletedSpinning);
+		}
+		if (bCompletedSpinning)
+		{
+			return true;
+		}
+
+		// Register a single waiter with every event, completed ones signal it right away
+		const bool bWaitAll = requiredCount == events.size();
+		uint32_t eventCount = static_cast<uint32_t>(std::count_if(events.begin(), events.end(), [](const auto& event) { return event != nullptr; }));
+		TaskEventWaiter waiter(bWaitAll ? eventCount : 1);
+		for (const auto& event : events)
+		{
+			if (event && !event->AddWaiter(&waiter))
+			{
+				waiter.Signal();
+			}
+		}
+
+		while (!waiter.IsSignaled())
+		{
+			if (worker && worker->TryExecuteTask())
+			{
+				continue;
+			}
+			if (std::chrono::steady_clock::now() >= deadline)
+			{
+				break;
+			}
+			waiter.Wait(worker ? std::min(deadline, std::chrono::steady_clock::now() + SpinPolicy::GetWorkerWaitSlice()) : deadline);
+		}
+
+		for (const auto& event : events)
+		{
+			if (event)
+			{
+				event->RemoveWaiter(&waiter);
+			}
+		}
+		return waiter.IsSignaled() || countCompleted() >= requiredCount;
+	}
 
 	std::shared_ptr<SV::TaskEvent> JobTask::CreateAndDispatch(TaskFunction&& function, const std::vector<std::shared_ptr<TaskEvent>>& prerequisites, ENamedThreads desiredThread /*= ENamedThreads::AnyThread*/)
 	{
 		std::shared_ptr<JobTask> task = std::make_shared<JobTask>(std::move(function), desiredThread);
+		return Launch(std::move(task), prerequisites);
+	}
+
+	std::shared_ptr<SV::TaskEvent> JobTask::CreateAndDispatch(TaskFunction&& function, const std::vector<std::shared_ptr<TaskEvent>>& prerequisites, const TaskParams& params)
+	{
+		std::shared_ptr<JobTask> task = std::make_shared<JobTask>(std::move(function), params);
+		return Launch(std::move(task), prerequisites);
+	}
+
+	std::shared_ptr<SV::TaskEvent> JobTask::DispatchAfter(std::chrono::steady_clock::duration delay, TaskFunction&& function)
+	{
+		return DispatchAt(std::chrono::steady_clock::now() + delay, std::move(function));
+	}
+
+	std::shared_ptr<SV::TaskEvent> JobTask::DispatchAt(std::chrono::steady_clock::time_point time, TaskFunction&& function)
+	{
+		std::shared_ptr<JobTask> task = std::make_shared<JobTask>(std::move(function));
 		std::shared_ptr<TaskEvent> taskEvent = std::make_shared<TaskEvent>();
 		task->SetEvent(taskEvent);
-		
-		int32_t pendingCount = 0;
-		for (const auto& prereq : prerequisites)
+
+		JobSystem& scheduler = task->GetScheduler();
+		scheduler.GetTimerWheel().Schedule(time, std::move(task));
+		scheduler.WakeTimerKeeper();
+		return taskEvent;
+	}
+
+	SV::TimerHandle JobTask::DispatchEvery(std::chrono::steady_clock::duration period, TaskFunction&& function)
+	{
+		JobSystem& scheduler = JobSystem::GetCurrent();
+		TimerHandle handle = scheduler.GetTimerWheel().SchedulePeriodic(std::chrono::steady_clock::now() + period, period, std::move(function));
+		scheduler.WakeTimerKeeper();
+		return handle;
+	}
+
+	std::shared_ptr<SV::TaskEvent> JobTask::Launch(std::shared_ptr<JobTask> task, const std::vector<std::shared_ptr<TaskEvent>>& prerequisites)
+	{
+		// Event may be created up front by callers that need to reference it before dispatch
+		std::shared_ptr<TaskEvent> taskEvent = task->GetEvent();
+		if (!taskEvent)
 		{
-			if (prereq && !prereq->IsComplete())
-			{
-				pendingCount++;
-			}
+			taskEvent = std::make_shared<TaskEvent>();
+			task->SetEvent(taskEvent);
 		}
 
-		if (pendingCount > 0)
+		TaskGraphRecorder& graphRecorder = task->GetScheduler().GetGraphRecorder();
+		if (graphRecorder.IsCapturing())
 		{
+			std::vector<uint64_t> prerequisiteIds;
 			for (const auto& prereq : prerequisites)
 			{
-				if (prereq && !prereq->IsComplete())
+				if (prereq && prereq->GetTraceId() != 0)
 				{
-					prereq->AddSubsequent(task);
-					pendingCount++;
+					prerequisiteIds.push_back(prereq->GetTraceId());
 				}
 			}
+			WorkerThread* spawnWorker = task->GetScheduler().GetCurrentWorker();
+			task->SetTraceId(graphRecorder.RecordLaunch(task->GetParams().Label, std::move(prerequisiteIds), spawnWorker ? spawnWorker->GetId() : -1));
+			taskEvent->SetTraceId(task->GetTraceId());
 		}
-		else
+
+		// Hold one extra count so the task can't be dispatched while prerequisites are still being registered
+		task->IncrementPrerequisiteCount();
+		for (const auto& prereq : prerequisites)
+		{
+			if (prereq)
+			{
+				prereq->AddSubsequent(task);
+			}
+		}
+
+		if (task->DecrementPrerequisiteCount() == 0)
 		{
-			JobSystem::Get().DispatchTask(task);
+			task->GetScheduler().DispatchTask(task);
 		}
 
 // 		if (prerequisites.empty() && desiredThread == ENamedThreads::AnyThread && JobSystem::Get().IsWorkerThread(std::this_thread::get_id()))
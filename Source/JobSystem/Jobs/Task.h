@@ -2,6 +2,8 @@
 #include "Core/Defines.h"
 #include "Threading/ThreadTypes.h"
 #include "Threading/Synchronization.h"
+#include "Jobs/TimerWheel.h"
+#include "Jobs/TaskMemory.h"
 
 #include <functional>
 #include <memory>
@@ -9,11 +11,43 @@
 #include <atomic>
 #include <mutex>
 #include <iostream>
+#include <chrono>
+#include <span>
 
 
 namespace SV
 {
 	class TaskEvent;
+	class TaskEventWaiter;
+	class TaskPipe;
+	class TaskGroup;
+	class JobSystem;
+
+	enum class ETaskFlags : uint8_t
+	{
+		None = 0,
+		Blocking = 1 << 0, // Body blocks in the OS, a spare worker covers for it while it runs
+		NoInline = 1 << 1, // Always queued when it becomes ready, never run as a continuation of its prerequisite
+		HardAffinity = 1 << 2, // Only the preferred worker runs it, otherwise others steal it after the group affinity steal delay
+		NotCancellable = 1 << 3, // Still runs while shutdown cancels queued work, for tasks that drain or complete other work
+	};
+	ENUM_CLASS_FLAGS(ETaskFlags)
+
+	struct TaskParams
+	{
+		ENamedThreads DesiredThread = ENamedThreads::AnyThread;
+		EWorkerGroup Group = EWorkerGroup::Foreground;
+		ETaskFlags Flags = ETaskFlags::None;
+		// Ready tasks with a deadline run earliest deadline first, ahead of tasks without one
+		std::chrono::steady_clock::time_point Deadline = std::chrono::steady_clock::time_point::max();
+		// Routes the task to one worker's mailbox, e.g. to keep a data partition in the same core cache every frame.
+		// Worker index is relative to the group and wraps around, the cpu mask selects the first worker pinned to one of its cores
+		int32_t PreferredWorker = -1;
+		uint64_t PreferredCpuMask = 0;
+		const char* Label = nullptr; // Shows up in graph captures and label stats, must outlive the task, e.g. a string literal
+		// Instance running the task. Null picks the instance of the launching worker, the default one on other threads
+		JobSystem* Scheduler = nullptr;
+	};
 
 	class JobTask
 	{
@@ -22,20 +56,39 @@ namespace SV
 
 		JobTask(TaskFunction&& function, ENamedThreads desiredThread = ENamedThreads::AnyThread)
 			: m_TaskEntryPoint(std::move(function))
-			, m_DesiredThread(desiredThread)
 			, m_PrerequisiteCount(0)
 		{
+			m_Params.DesiredThread = desiredThread;
+			m_Params.Scheduler = ResolveScheduler(nullptr);
+		}
+
+		JobTask(TaskFunction&& function, const TaskParams& params)
+			: m_TaskEntryPoint(std::move(function))
+			, m_Params(params)
+			, m_PrerequisiteCount(0)
+		{
+			m_Params.Scheduler = ResolveScheduler(params.Scheduler);
 		}
 
 		void DoTask()
 		{
 			if (m_TaskEntryPoint)
 			{
+				ScopedScratch scratch;
 				m_TaskEntryPoint();
 			}
 		}
 
-		ENamedThreads GetDesiredThread() const { return m_DesiredThread; }
+		ENamedThreads GetDesiredThread() const { return m_Params.DesiredThread; }
+		EWorkerGroup GetGroup() const { return m_Params.Group; }
+		bool HasFlags(ETaskFlags flags) const { return EnumHasAnyFlags(m_Params.Flags, flags); }
+		bool HasAffinity() const { return m_Params.PreferredWorker >= 0 || m_Params.PreferredCpuMask != 0; }
+		bool HasDeadline() const { return m_Params.Deadline != std::chrono::steady_clock::time_point::max(); }
+		std::chrono::steady_clock::time_point GetDeadline() const { return m_Params.Deadline; }
+		const TaskParams& GetParams() const { return m_Params; }
+		JobSystem& GetScheduler() const { return *m_Params.Scheduler; }
+		// Dispatching to another instance moves the task there
+		void SetScheduler(JobSystem* scheduler) { m_Params.Scheduler = scheduler; }
 		void IncrementPrerequisiteCount()
 		{
 			m_PrerequisiteCount.fetch_add(1, std::memory_order_relaxed);
@@ -59,6 +112,26 @@ namespace SV
 			return m_AssociatedEvent;
 		}
 
+		void SetPipe(TaskPipe* pipe) { m_Pipe = pipe; }
+		TaskPipe* GetPipe() const { return m_Pipe; }
+
+		// Branch of a TaskGroup, counted down by the executing worker instead of completing an event
+		void SetTaskGroup(TaskGroup* taskGroup) { m_TaskGroup = taskGroup; }
+		TaskGroup* GetTaskGroup() const { return m_TaskGroup; }
+
+		// Non-zero if launched during a graph capture
+		uint64_t GetTraceId() const { return m_TraceId; }
+		void SetTraceId(uint64_t traceId) { m_TraceId = traceId; }
+		std::chrono::steady_clock::time_point GetReadyTime() const { return m_ReadyTime; }
+		// Only for tasks the scheduler times, see JobSystem::IsTaskTimed
+		void MarkReady() { m_ReadyTime = std::chrono::steady_clock::now(); }
+
+		// Pipe and named thread tasks must go through their queues
+		bool CanRunInline() const
+		{
+			return !m_Pipe && m_Params.DesiredThread == ENamedThreads::AnyThread && !HasFlags(ETaskFlags::NoInline);
+		}
+
 		static std::shared_ptr<TaskEvent> CreateAndDispatch(TaskFunction&& function, std::shared_ptr<TaskEvent> prerequisite = nullptr, ENamedThreads desiredThread = ENamedThreads::AnyThread)
 		{
 			std::vector<std::shared_ptr<TaskEvent>> prerequisites;
@@ -71,12 +144,28 @@ namespace SV
 		}
 
 		static std::shared_ptr<TaskEvent> CreateAndDispatch(TaskFunction&& function, const std::vector<std::shared_ptr<TaskEvent>>& prerequisites, ENamedThreads desiredThread = ENamedThreads::AnyThread);
+		static std::shared_ptr<TaskEvent> CreateAndDispatch(TaskFunction&& function, const std::vector<std::shared_ptr<TaskEvent>>& prerequisites, const TaskParams& params);
+
+		// Timer tasks, kept in the job system timer wheel and pushed to the normal queues on expiration
+		static std::shared_ptr<TaskEvent> DispatchAfter(std::chrono::steady_clock::duration delay, TaskFunction&& function);
+		static std::shared_ptr<TaskEvent> DispatchAt(std::chrono::steady_clock::time_point time, TaskFunction&& function);
+		static TimerHandle DispatchEvery(std::chrono::steady_clock::duration period, TaskFunction&& function);
+
+		// Dispatches an already constructed task once all prerequisites complete, creates its event if it has none
+		static std::shared_ptr<TaskEvent> Launch(std::shared_ptr<JobTask> task, const std::vector<std::shared_ptr<TaskEvent>>& prerequisites);
+
+	private:
+		static JobSystem* ResolveScheduler(JobSystem* scheduler);
 
 	private:
 		TaskFunction m_TaskEntryPoint;
-		ENamedThreads m_DesiredThread;
+		TaskParams m_Params;
 		std::atomic<int32_t> m_PrerequisiteCount;
 		std::shared_ptr<TaskEvent> m_AssociatedEvent;
+		TaskPipe* m_Pipe = nullptr;
+		TaskGroup* m_TaskGroup = nullptr;
+		uint64_t m_TraceId = 0;
+		std::chrono::steady_clock::time_point m_ReadyTime;
 	};
 
 
@@ -86,17 +175,68 @@ namespace SV
 	public:
 		TaskEvent() = default;
 
-		void AddSubsequent(std::shared_ptr<JobTask> task);
-		void Complete();
-		void Wait(); // Blocking wait for completion
+		bool AddSubsequent(std::shared_ptr<JobTask> task); // Returns false if already completed
+		// Given outContinuation, one ready subsequent that can run inline is returned there instead of dispatched
+		void Complete(std::shared_ptr<JobTask>* outContinuation = nullptr);
 		bool IsComplete() const
 		{
 			return m_Completed.load(std::memory_order_acquire);
 		}
+
+		// Completes without the task having run, e.g. when cancelled at shutdown. Subsequents still become ready
+		void Abandon()
+		{
+			m_bAbandoned.store(true, std::memory_order_relaxed);
+			Complete();
+		}
+		// Valid once complete
+		bool IsAbandoned() const { return m_bAbandoned.load(std::memory_order_relaxed); }
+
+		// Trace id of the task completing the event, links graph capture edges
+		uint64_t GetTraceId() const { return m_TraceId; }
+		void SetTraceId(uint64_t traceId) { m_TraceId = traceId; }
+
+		// Blocking waits. Spin briefly, then sleep on a futex until completion is notified.
+		// Called from a worker, they execute other queued tasks instead of blocking the worker.
+		void Wait();
+		bool WaitUntil(std::chrono::steady_clock::time_point deadline); // Returns false on timeout
+		template<typename Rep, typename Period>
+		bool WaitFor(const std::chrono::duration<Rep, Period>& timeout)
+		{
+			return WaitUntil(std::chrono::steady_clock::now() + timeout);
+		}
+
+		// Wait on many events with a single waiter. Null events are treated as complete
+		static void WaitAll(std::span<const std::shared_ptr<TaskEvent>> events);
+		static bool WaitAllUntil(std::span<const std::shared_ptr<TaskEvent>> events, std::chrono::steady_clock::time_point deadline);
+		template<typename Rep, typename Period>
+		static bool WaitAllFor(std::span<const std::shared_ptr<TaskEvent>> events, const std::chrono::duration<Rep, Period>& timeout)
+		{
+			return WaitAllUntil(events, std::chrono::steady_clock::now() + timeout);
+		}
+
+		// Returns index of a completed event, -1 on timeout
+		static int32_t WaitAny(std::span<const std::shared_ptr<TaskEvent>> events);
+		static int32_t WaitAnyUntil(std::span<const std::shared_ptr<TaskEvent>> events, std::chrono::steady_clock::time_point deadline);
+		template<typename Rep, typename Period>
+		static int32_t WaitAnyFor(std::span<const std::shared_ptr<TaskEvent>> events, const std::chrono::duration<Rep, Period>& timeout)
+		{
+			return WaitAnyUntil(events, std::chrono::steady_clock::now() + timeout);
+		}
+
+	private:
+		bool AddWaiter(TaskEventWaiter* waiter); // Returns false if already completed
+		void RemoveWaiter(TaskEventWaiter* waiter);
+
+		static bool WaitInternal(std::span<const std::shared_ptr<TaskEvent>> events, uint32_t requiredCount, std::chrono::steady_clock::time_point deadline);
+
 	private:
 		std::vector<std::shared_ptr<JobTask>> m_Subsequents;
+		std::vector<TaskEventWaiter*> m_Waiters;
 		std::atomic<bool> m_Completed{ false };
-		SpinLock m_Lock; // Protects m_Subsequents vector
+		std::atomic<bool> m_bAbandoned{ false };
+		uint64_t m_TraceId = 0;
+		AdaptiveLock m_Lock; // Protects m_Subsequents and m_Waiters vectors
 	};
 
 }
\ No newline at end of file
@@ -0,0 +1,478 @@
+#include "TaskGraph.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+namespace SV
+{
+	namespace
+	{
+		constexpr char WORKLOAD_MAGIC[4] = { 'S', 'V', 'W', 'L' };
+		constexpr uint64_t WORKLOAD_VERSION = 1;
+		constexpr const char* SPAWN_COLUMNS_HEADER = "spawner\tlaunch_ns";
+		// Smallest encoding of a node, one byte for each of the 9 varints SaveBinary writes per node
+		constexpr uint64_t MIN_NODE_BYTES = 9;
+
+		// LEB128, small values and deltas take a byte or two
+		void WriteVarint(std::ostream& stream, uint64_t value)
+		{
+			while (value >= 0x80)
+			{
+				stream.put(static_cast<char>((value & 0x7F) | 0x80));
+				value >>= 7;
+			}
+			stream.put(static_cast<char>(value));
+		}
+
+		bool ReadVarint(std::istream& stream, uint64_t& outValue)
+		{
+			outValue = 0;
+			for (int32_t shift = 0; shift < 64; shift += 7)
+			{
+				const int32_t byte = stream.get();
+				if (byte == std::char_traits<char>::eof())
+				{
+					return false;
+				}
+				outValue |= static_cast<uint64_t>(byte & 0x7F) << shift;
+				if ((byte & 0x80) == 0)
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		void WriteSigned(std::ostream& stream, int64_t value)
+		{
+			WriteVarint(stream, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+		}
+
+		bool ReadSigned(std::istream& stream, int64_t& outValue)
+		{
+			uint64_t value = 0;
+			if (!ReadVarint(stream, value))
+			{
+				return false;
+			}
+			outValue = static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+			return true;
+		}
+
+		// Counts are checked against the bytes left before anything is allocated, corrupt files fail instead of throwing
+		bool LoadBinary(std::istream& file, uint64_t fileSize, TaskGraph& outGraph)
+		{
+			auto getRemainingBytes = [&file, fileSize]()
+				{
+					const std::streamoff position = file.tellg();
+					return position < 0 ? 0 : fileSize - std::min(fileSize, static_cast<uint64_t>(position));
+				};
+
+			uint64_t version = 0;
+			uint64_t labelCount = 0;
+			if (!ReadVarint(file, version) || version != WORKLOAD_VERSION || !ReadVarint(file, labelCount) || labelCount > getRemainingBytes())
+			{
+				return false;
+			}
+			std::vector<std::string> labels(labelCount);
+			for (std::string& label : labels)
+			{
+				uint64_t length = 0;
+				if (!ReadVarint(file, length) || length > getRemainingBytes())
+				{
+					return false;
+				}
+				label.resize(length);
+				if (!file.read(label.data(), static_cast<std::streamsize>(length)))
+				{
+					return false;
+				}
+			}
+
+			uint64_t nodeCount = 0;
+			if (!ReadVarint(file, nodeCount) || nodeCount > getRemainingBytes() / MIN_NODE_BYTES)
+			{
+				return false;
+			}
+			outGraph.Nodes.clear();
+			outGraph.Nodes.reserve(nodeCount);
+			uint64_t previousId = 0;
+			for (uint64_t i = 0; i < nodeCount; ++i)
+			{
+				TaskGraphNode node;
+				uint64_t idDelta = 0, labelIndex = 0, prerequisiteCount = 0;
+				int64_t spawnWorkerId = 0, workerId = 0, readyDelta = 0, startDelta = 0, duration = 0;
+				if (!ReadVarint(file, idDelta) || !ReadVarint(file, labelIndex) || labelIndex >= labels.size()
+					|| !ReadSigned(file, spawnWorkerId) || !ReadSigned(file, workerId) || !ReadSigned(file, node.LaunchTimeNs)
+					|| !ReadSigned(file, readyDelta) || !ReadSigned(file, startDelta) || !ReadSigned(file, duration)
+					|| !ReadVarint(file, prerequisiteCount) || prerequisiteCount > getRemainingBytes())
+				{
+					return false;
+				}
+				node.Id = previousId + idDelta;
+				previousId = node.Id;
+				node.Label = labels[labelIndex];
+				node.SpawnWorkerId = static_cast<int32_t>(spawnWorkerId);
+				node.WorkerId = static_cast<int32_t>(workerId);
+				if (duration > 0)
+				{
+					node.ReadyTimeNs = node.LaunchTimeNs + readyDelta;
+					node.StartTimeNs = node.ReadyTimeNs + startDelta;
+					node.EndTimeNs = node.StartTimeNs + duration;
+				}
+				for (uint64_t j = 0; j < prerequisiteCount; ++j)
+				{
+					// Prerequisites launch before their subsequents, a self or forward reference would deadlock a replay
+					uint64_t prerequisiteDelta = 0;
+					if (!ReadVarint(file, prerequisiteDelta) || prerequisiteDelta == 0 || prerequisiteDelta > node.Id)
+					{
+						return false;
+					}
+					node.Prerequisites.push_back(node.Id - prerequisiteDelta);
+				}
+				outGraph.Nodes.push_back(std::move(node));
+			}
+			return true;
+		}
+	}
+
+	const TaskGraphNode* TaskGraph::FindNode(uint64_t id) const
+	{
+		auto it = std::lower_bound(Nodes.begin(), Nodes.end(), id,
+			[](const TaskGraphNode& node, uint64_t value) { return node.Id < value; });
+		return it != Nodes.end() && it->Id == id ? &*it : nullptr;
+	}
+
+	bool TaskGraph::Save(const std::string& path) const
+	{
+		std::ofstream file(path);
+		if (!file)
+		{
+			return false;
+		}
+
+		// Columns added later go after the label, Load tells the layouts apart by the header
+		file << "# id\tworker\tready_ns\tstart_ns\tend_ns\tprerequisites\tlabel\t" << SPAWN_COLUMNS_HEADER << "\n";
+		for (const TaskGraphNode& node : Nodes)
+		{
+			file << node.Id << '\t' << node.WorkerId << '\t' << node.ReadyTimeNs << '\t' << node.StartTimeNs << '\t' << node.EndTimeNs << '\t';
+			for (size_t i = 0; i < node.Prerequisites.size(); ++i)
+			{
+				file << (i > 0 ? "," : "") << node.Prerequisites[i];
+			}
+			if (node.Prerequisites.empty())
+			{
+				file << '-';
+			}
+			file << '\t' << node.Label << '\t' << node.SpawnWorkerId << '\t' << node.LaunchTimeNs << '\n';
+		}
+		return static_cast<bool>(file);
+	}
+
+	bool TaskGraph::SaveBinary(const std::string& path) const
+	{
+		std::ofstream file(path, std::ios::binary);
+		if (!file)
+		{
+			return false;
+		}
+
+		std::vector<const std::string*> labels;
+		std::unordered_map<std::string, uint64_t> labelIndices;
+		for (const TaskGraphNode& node : Nodes)
+		{
+			if (labelIndices.emplace(node.Label, labels.size()).second)
+			{
+				labels.push_back(&node.Label);
+			}
+		}
+
+		file.write(WORKLOAD_MAGIC, sizeof(WORKLOAD_MAGIC));
+		WriteVarint(file, WORKLOAD_VERSION);
+		WriteVarint(file, labels.size());
+		for (const std::string* label : labels)
+		{
+			WriteVarint(file, label->size());
+			file.write(label->data(), static_cast<std::streamsize>(label->size()));
+		}
+
+		// Ids as deltas and times relative to the previous step of the same task, a duration of 0 means it didn't run
+		WriteVarint(file, Nodes.size());
+		uint64_t previousId = 0;
+		for (const TaskGraphNode& node : Nodes)
+		{
+			WriteVarint(file, node.Id - previousId);
+			previousId = node.Id;
+			WriteVarint(file, labelIndices[node.Label]);
+			WriteSigned(file, node.SpawnWorkerId);
+			WriteSigned(file, node.WorkerId);
+			WriteSigned(file, node.LaunchTimeNs);
+			WriteSigned(file, node.HasRun() ? node.ReadyTimeNs - node.LaunchTimeNs : 0);
+			WriteSigned(file, node.HasRun() ? node.StartTimeNs - node.ReadyTimeNs : 0);
+			WriteSigned(file, node.HasRun() ? std::max<int64_t>(1, node.GetDurationNs()) : 0);
+			WriteVarint(file, node.Prerequisites.size());
+			for (uint64_t prerequisiteId : node.Prerequisites)
+			{
+				WriteVarint(file, node.Id - prerequisiteId);
+			}
+		}
+		return static_cast<bool>(file);
+	}
+
+	bool TaskGraph::Load(const std::string& path, TaskGraph& outGraph)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file)
+		{
+			return false;
+		}
+
+		file.seekg(0, std::ios::end);
+		const uint64_t fileSize = static_cast<uint64_t>(std::max<std::streamoff>(0, file.tellg()));
+		file.seekg(0);
+		char magic[sizeof(WORKLOAD_MAGIC)] = {};
+		file.read(magic, sizeof(magic));
+		if (file && std::memcmp(magic, WORKLOAD_MAGIC, sizeof(magic)) == 0)
+		{
+			return LoadBinary(file, fileSize, outGraph);
+		}
+		file.clear();
+		file.seekg(0);
+
+		outGraph.Nodes.clear();
+		bool bSpawnColumns = false; // Captures from before workload recording end with the label
+		std::string line;
+		while (std::getline(file, line))
+		{
+			if (line.empty() || line[0] == '#')
+			{
+				bSpawnColumns = bSpawnColumns || line.find(SPAWN_COLUMNS_HEADER) != std::string::npos;
+				continue;
+			}
+
+			std::istringstream fields(line);
+			TaskGraphNode node;
+			std::string prerequisites;
+			fields >> node.Id >> node.WorkerId >> node.ReadyTimeNs >> node.StartTimeNs >> node.EndTimeNs >> prerequisites;
+			if (!fields)
+			{
+				return false;
+			}
+			// Label is the rest of the line after the tab, it may contain spaces
+			fields.get();
+			std::getline(fields, node.Label);
+			if (bSpawnColumns)
+			{
+				const size_t launchTab = node.Label.rfind('\t');
+				const size_t spawnerTab = launchTab == std::string::npos || launchTab == 0 ? std::string::npos : node.Label.rfind('\t', launchTab - 1);
+				if (spawnerTab == std::string::npos)
+				{
+					return false;
+				}
+				std::istringstream spawnFields(node.Label.substr(spawnerTab + 1));
+				spawnFields >> node.SpawnWorkerId >> node.LaunchTimeNs;
+				if (!spawnFields)
+				{
+					return false;
+				}
+				node.Label.resize(spawnerTab);
+			}
+
+			if (prerequisites != "-")
+			{
+				std::istringstream ids(prerequisites);
+				std::string id;
+				while (std::getline(ids, id, ','))
+				{
+					uint64_t prerequisiteId = 0;
+					const std::from_chars_result result = std::from_chars(id.data(), id.data() + id.size(), prerequisiteId);
+					if (result.ec != std::errc() || result.ptr != id.data() + id.size() || prerequisiteId >= node.Id)
+					{
+						return false;
+					}
+					node.Prerequisites.push_back(prerequisiteId);
+				}
+			}
+			outGraph.Nodes.push_back(std::move(node));
+		}
+
+		std::sort(outGraph.Nodes.begin(), outGraph.Nodes.end(),
+			[](const TaskGraphNode& a, const TaskGraphNode& b) { return a.Id < b.Id; });
+		return true;
+	}
+
+	TaskGraphAnalysis AnalyzeTaskGraph(const TaskGraph& graph, std::chrono::nanoseconds profileBucket /*= 100us*/)
+	{
+		TaskGraphAnalysis analysis;
+
+		int64_t firstReady = INT64_MAX;
+		int64_t lastEnd = 0;
+		const TaskGraphNode* lastNode = nullptr;
+		for (const TaskGraphNode& node : graph.Nodes)
+		{
+			if (!node.HasRun())
+			{
+				continue;
+			}
+			firstReady = std::min(firstReady, node.ReadyTimeNs);
+			if (node.EndTimeNs > lastEnd)
+			{
+				lastEnd = node.EndTimeNs;
+				lastNode = &node;
+			}
+			analysis.TotalWorkNs += node.GetDurationNs();
+
+			for (uint64_t prerequisiteId : node.Prerequisites)
+			{
+				const TaskGraphNode* prerequisite = graph.FindNode(prerequisiteId);
+				if (prerequisite && prerequisite->HasRun())
+				{
+					analysis.Edges.push_back({ prerequisiteId, node.Id, node.StartTimeNs - prerequisite->EndTimeNs });
+				}
+			}
+		}
+		if (!lastNode)
+		{
+			return analysis;
+		}
+
+		analysis.SpanNs = lastEnd - firstReady;
+		analysis.AverageParallelism = analysis.SpanNs > 0 ? static_cast<double>(analysis.TotalWorkNs) / static_cast<double>(analysis.SpanNs) : 0.0;
+		std::sort(analysis.Edges.begin(), analysis.Edges.end(),
+			[](const TaskGraphEdge& a, const TaskGraphEdge& b) { return a.DelayNs > b.DelayNs; });
+
+		// Walk back from the task that finished last
+		for (const TaskGraphNode* node = lastNode; node;)
+		{
+			analysis.CriticalPath.push_back(node->Id);
+			analysis.CriticalPathWorkNs += node->GetDurationNs();
+
+			const TaskGraphNode* enabling = nullptr;
+			for (uint64_t prerequisiteId : node->Prerequisites)
+			{
+				const TaskGraphNode* prerequisite = graph.FindNode(prerequisiteId);
+				if (prerequisite && prerequisite->HasRun() && (!enabling || prerequisite->EndTimeNs > enabling->EndTimeNs))
+				{
+					enabling = prerequisite;
+				}
+			}
+			// Head of the chain waited in a queue since it became ready
+			analysis.CriticalPathDelayNs += node->StartTimeNs - (enabling ? enabling->EndTimeNs : node->ReadyTimeNs);
+			node = enabling;
+		}
+		std::reverse(analysis.CriticalPath.begin(), analysis.CriticalPath.end());
+
+		const int64_t bucketNs = std::max<int64_t>(1, profileBucket.count());
+		const size_t bucketCount = static_cast<size_t>((analysis.SpanNs + bucketNs - 1) / bucketNs);
+		analysis.Profile.resize(bucketCount);
+		for (size_t i = 0; i < bucketCount; ++i)
+		{
+			analysis.Profile[i].TimeNs = firstReady + static_cast<int64_t>(i) * bucketNs;
+		}
+		for (const TaskGraphNode& node : graph.Nodes)
+		{
+			if (!node.HasRun())
+			{
+				continue;
+			}
+			size_t firstBucket = static_cast<size_t>(std::max<int64_t>(0, node.StartTimeNs - firstReady) / bucketNs);
+			for (size_t i = firstBucket; i < bucketCount; ++i)
+			{
+				int64_t bucketStart = analysis.Profile[i].TimeNs;
+				if (bucketStart >= node.EndTimeNs)
+				{
+					break;
+				}
+				int64_t overlap = std::min(node.EndTimeNs, bucketStart + bucketNs) - std::max(node.StartTimeNs, bucketStart);
+				analysis.Profile[i].RunningTasks += static_cast<double>(overlap) / static_cast<double>(bucketNs);
+			}
+		}
+		return analysis;
+	}
+
+	void TaskGraphRecorder::Begin()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Launches.clear();
+		m_Executions.clear();
+		m_FirstId = m_NextId.load(std::memory_order_relaxed);
+		m_CaptureStart = Clock::now();
+		m_bCapturing.store(true, std::memory_order_release);
+	}
+
+	TaskGraph TaskGraphRecorder::End()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_bCapturing.store(false, std::memory_order_release);
+
+		auto toNs = [this](Clock::time_point time)
+			{
+				return std::chrono::duration_cast<std::chrono::nanoseconds>(time - m_CaptureStart).count();
+			};
+
+		TaskGraph graph;
+		graph.Nodes.reserve(m_Launches.size());
+		for (LaunchRecord& launch : m_Launches)
+		{
+			TaskGraphNode node;
+			node.Id = launch.Id;
+			node.Label = launch.Label ? launch.Label : "";
+			node.Prerequisites = std::move(launch.Prerequisites);
+			node.SpawnWorkerId = launch.SpawnWorkerId;
+			node.LaunchTimeNs = toNs(launch.LaunchTime);
+			graph.Nodes.push_back(std::move(node));
+		}
+		// Ids are taken before the lock, launches may be recorded slightly out of order
+		std::sort(graph.Nodes.begin(), graph.Nodes.end(),
+			[](const TaskGraphNode& a, const TaskGraphNode& b) { return a.Id < b.Id; });
+
+		for (const ExecutionRecord& execution : m_Executions)
+		{
+			auto it = std::lower_bound(graph.Nodes.begin(), graph.Nodes.end(), execution.Id,
+				[](const TaskGraphNode& node, uint64_t value) { return node.Id < value; });
+			if (it != graph.Nodes.end() && it->Id == execution.Id)
+			{
+				it->WorkerId = execution.WorkerId;
+				it->ReadyTimeNs = toNs(execution.ReadyTime);
+				it->StartTimeNs = toNs(execution.StartTime);
+				it->EndTimeNs = std::max<int64_t>(1, toNs(execution.EndTime));
+			}
+		}
+
+		m_Launches.clear();
+		m_Executions.clear();
+		return graph;
+	}
+
+	uint64_t TaskGraphRecorder::RecordLaunch(const char* label, std::vector<uint64_t>&& prerequisites, int32_t spawnWorkerId)
+	{
+		if (!IsCapturing())
+		{
+			return 0;
+		}
+
+		const Clock::time_point launchTime = Clock::now();
+		uint64_t id = m_NextId.fetch_add(1, std::memory_order_relaxed);
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (!m_bCapturing.load(std::memory_order_relaxed) || id < m_FirstId)
+		{
+			return 0;
+		}
+		m_Launches.push_back({ id, label, std::move(prerequisites), spawnWorkerId, launchTime });
+		return id;
+	}
+
+	void TaskGraphRecorder::RecordExecution(uint64_t id, int32_t workerId, Clock::time_point readyTime, Clock::time_point startTime, Clock::time_point endTime)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (!m_bCapturing.load(std::memory_order_relaxed) || id < m_FirstId)
+		{
+			return;
+		}
+		m_Executions.push_back({ id, workerId, readyTime, startTime, endTime });
+	}
+}
@@ -0,0 +1,123 @@
+#pragma once
+#include "Core/Defines.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace SV
+{
+	// One launched task of a captured graph, times are relative to the capture start
+	struct TaskGraphNode
+	{
+		uint64_t Id = 0;
+		std::string Label;
+		std::vector<uint64_t> Prerequisites; // Only prerequisites launched during the capture
+		int32_t SpawnWorkerId = -1; // Worker the task was launched from, -1 for other threads
+		int32_t WorkerId = -1; // -1 if the task didn't finish during the capture or ran outside the workers
+		int64_t LaunchTimeNs = 0;
+		int64_t ReadyTimeNs = 0; // Dispatched to a queue or handed to its worker as a continuation
+		int64_t StartTimeNs = 0;
+		int64_t EndTimeNs = 0;
+
+		bool HasRun() const { return EndTimeNs > 0; }
+		int64_t GetDurationNs() const { return EndTimeNs - StartTimeNs; }
+	};
+
+	struct TaskGraph
+	{
+		std::vector<TaskGraphNode> Nodes; // Sorted by id, prerequisites come before their subsequents
+
+		const TaskGraphNode* FindNode(uint64_t id) const;
+
+		// Tab separated text, one node per line
+		bool Save(const std::string& path) const;
+		// Compact binary workload file, e.g. for the WorkloadReplay tool. Labels are stored once
+		bool SaveBinary(const std::string& path) const;
+		// Reads either format
+		static bool Load(const std::string& path, TaskGraph& outGraph);
+	};
+
+	struct TaskGraphEdge
+	{
+		uint64_t From = 0;
+		uint64_t To = 0;
+		int64_t DelayNs = 0; // Prerequisite end to subsequent start
+	};
+
+	struct ParallelismSample
+	{
+		int64_t TimeNs = 0; // Bucket start
+		double RunningTasks = 0.0; // Average over the bucket
+	};
+
+	struct TaskGraphAnalysis
+	{
+		int64_t SpanNs = 0; // First ready time to last end time
+		int64_t TotalWorkNs = 0;
+		double AverageParallelism = 0.0;
+
+		// Chain that finished last, walked back through the prerequisite that finished last at every step.
+		// Work dominating the path means the tasks are too long, delay dominating it means dependencies or scheduling hold it up
+		std::vector<uint64_t> CriticalPath;
+		int64_t CriticalPathWorkNs = 0;
+		int64_t CriticalPathDelayNs = 0;
+
+		std::vector<TaskGraphEdge> Edges; // Sorted by delay, longest first
+		std::vector<ParallelismSample> Profile;
+	};
+
+	TaskGraphAnalysis AnalyzeTaskGraph(const TaskGraph& graph, std::chrono::nanoseconds profileBucket = std::chrono::microseconds(100));
+
+	// Records the runtime DAG between Begin and End. Tasks launched through JobTask::Launch are captured,
+	// when not capturing the cost is one relaxed load per launch
+	class TaskGraphRecorder
+	{
+		NONCOPYABLE_NONMOVABLE(TaskGraphRecorder);
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		TaskGraphRecorder() = default;
+		~TaskGraphRecorder() = default;
+
+		void Begin();
+		// Tasks still queued or running are included without execution times
+		TaskGraph End();
+		bool IsCapturing() const { return m_bCapturing.load(std::memory_order_relaxed); }
+
+		// Returns the trace id of the task, 0 if not capturing. Label must outlive the capture, e.g. a string literal
+		uint64_t RecordLaunch(const char* label, std::vector<uint64_t>&& prerequisites, int32_t spawnWorkerId);
+		void RecordExecution(uint64_t id, int32_t workerId, Clock::time_point readyTime, Clock::time_point startTime, Clock::time_point endTime);
+
+	private:
+		struct LaunchRecord
+		{
+			uint64_t Id;
+			const char* Label;
+			std::vector<uint64_t> Prerequisites;
+			int32_t SpawnWorkerId;
+			Clock::time_point LaunchTime;
+		};
+
+		struct ExecutionRecord
+		{
+			uint64_t Id;
+			int32_t WorkerId;
+			Clock::time_point ReadyTime;
+			Clock::time_point StartTime;
+			Clock::time_point EndTime;
+		};
+
+		std::atomic<bool> m_bCapturing{ false };
+		std::atomic<uint64_t> m_NextId{ 1 };
+		uint64_t m_FirstId = 1; // Tasks of an earlier capture finishing late are ignored
+		Clock::time_point m_CaptureStart;
+
+		std::mutex m_Mutex;
+		std::vector<LaunchRecord> m_Launches;
+		std::vector<ExecutionRecord> m_Executions;
+	};
+}
@@ -0,0 +1,221 @@
+#include "TaskGroup.h"
+#include "JobSystem.h"
+#include "WorkerThread.h"
+#include "SpinPolicy.h"
+#include "Platform/Platform.h"
+
+#include <algorithm>
+
+namespace SV
+{
+	TaskGroup::TaskGroup(ETaskSpawnMode mode /*= ETaskSpawnMode::WorkFirst*/, const TaskParams& params /*= TaskParams()*/)
+		: m_Params(params)
+	{
+		if (!m_Params.Scheduler)
+		{
+			m_Params.Scheduler = &JobSystem::GetCurrent();
+		}
+
+		// Inline runs must not move work onto a worker of another scheduler or group
+		WorkerThread* worker = WorkerThread::GetCurrent();
+		const bool bSameWorkers = !worker || (worker->GetJobSystem() == m_Params.Scheduler && worker->GetGroup() == m_Params.Group);
+		m_bRunNewestInline = mode == ETaskSpawnMode::WorkFirst && bSameWorkers
+			&& m_Params.DesiredThread == ENamedThreads::AnyThread
+			&& m_Params.PreferredWorker < 0 && m_Params.PreferredCpuMask == 0
+			&& !EnumHasAnyFlags(m_Params.Flags, ETaskFlags::NoInline | ETaskFlags::Blocking);
+	}
+
+	TaskGroup::~TaskGroup()
+	{
+		Wait();
+	}
+
+	void TaskGroup::SetCapacity(uint32_t maxOutstanding, EBackpressurePolicy policy /*= EBackpressurePolicy::RunInline*/)
+	{
+		m_Capacity = maxOutstanding;
+		m_Policy = policy;
+	}
+
+	void TaskGroup::Spawn(JobTask::TaskFunction&& function)
+	{
+		assert(!m_JoinTask && "Spawn after Then");
+		if (m_Capacity != 0 && (m_State.load(std::memory_order_acquire) & COUNT_MASK) >= m_Capacity && !WaitForCapacity(function))
+		{
+			return;
+		}
+		const uint32_t count = (m_State.fetch_add(1, std::memory_order_relaxed) & COUNT_MASK) + 1;
+		m_HighWaterMark = std::max(m_HighWaterMark, count);
+		if (!m_bRunNewestInline)
+		{
+			DispatchBranch(std::move(function));
+			return;
+		}
+		if (m_HeldFunction)
+		{
+			DispatchBranch(std::move(m_HeldFunction));
+		}
+		m_HeldFunction = std::move(function);
+	}
+
+	void TaskGroup::Wait()
+	{
+		if (m_HeldFunction)
+		{
+			RunHeldFunction();
+		}
+
+		// Branches nobody stole are still on top of the local queue, newest first
+		WorkerThread* worker = WorkerThread::GetCurrent();
+		while (!IsDone() && worker && worker->TryExecuteSpawnedTask(*this))
+		{
+		}
+
+		// Stolen branches, run other queued tasks meanwhile
+		AdaptiveSpinBudget& spinBudget = SpinPolicy::GetWaitBudget();
+		const uint32_t maxSpinCount = spinBudget.Get();
+		uint32_t spinCount = 0;
+		while (!IsDone() && spinCount < maxSpinCount)
+		{
+			if (worker && worker->TryExecuteTask())
+			{
+				continue;
+			}
+			++spinCount;
+			Platform::CpuPause();
+		}
+		if (spinCount > 0)
+		{
+			spinBudget.RecordOutcome(spinCount, IsDone());
+		}
+
+		uint32_t state = m_State.load(std::memory_order_acquire);
+		while ((state & COUNT_MASK) != 0)
+		{
+			if ((state & WAITER_BIT) == 0)
+			{
+				if (!m_State.compare_exchange_weak(state, state | WAITER_BIT, std::memory_order_acq_rel))
+				{
+					continue;
+				}
+				state |= WAITER_BIT;
+			}
+			// Workers wake up regularly to run tasks queued meanwhile
+			Platform::WaitOnAddress(m_State, state, worker ? std::chrono::steady_clock::now() + SpinPolicy::GetWorkerWaitSlice() : std::chrono::steady_clock::time_point::max());
+			while (worker && !IsDone() && worker->TryExecuteTask())
+			{
+			}
+			state = m_State.load(std::memory_order_acquire);
+		}
+
+		if (state & (WAITER_BIT | JOIN_BIT))
+		{
+			// The last branch still has to return from waking us or launching the join before the group may go away
+			while (!m_bWakeDone.load(std::memory_order_acquire))
+			{
+				Platform::CpuPause();
+			}
+			m_bWakeDone.store(false, std::memory_order_relaxed);
+			m_State.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	std::shared_ptr<TaskEvent> TaskGroup::Then(JobTask::TaskFunction&& continuation, const TaskParams& params /*= TaskParams()*/)
+	{
+		assert(!m_JoinTask && "Then called twice");
+		// Nobody would run it inline anymore
+		if (m_HeldFunction)
+		{
+			DispatchBranch(std::move(m_HeldFunction));
+			m_HeldFunction = nullptr;
+		}
+
+		TaskParams joinParams = params;
+		if (!joinParams.Scheduler)
+		{
+			joinParams.Scheduler = m_Params.Scheduler;
+		}
+		std::shared_ptr<JobTask> joinTask = std::make_shared<JobTask>(std::move(continuation), joinParams);
+		std::shared_ptr<TaskEvent> joinEvent = std::make_shared<TaskEvent>();
+		joinTask->SetEvent(joinEvent);
+
+		m_JoinTask = joinTask;
+		const uint32_t prevState = m_State.fetch_or(JOIN_BIT, std::memory_order_acq_rel);
+		if ((prevState & COUNT_MASK) == 0)
+		{
+			// Every branch is done already
+			m_State.fetch_and(~JOIN_BIT, std::memory_order_relaxed);
+			m_JoinTask = nullptr;
+			JobTask::Launch(std::move(joinTask), {});
+		}
+		return joinEvent;
+	}
+
+	bool TaskGroup::WaitForCapacity(JobTask::TaskFunction& function)
+	{
+		if (m_Policy == EBackpressurePolicy::RunInline)
+		{
+			ScopedScratch scratch;
+			function();
+			return false;
+		}
+
+		WorkerThread* worker = WorkerThread::GetCurrent();
+		const bool bHelp = m_Policy == EBackpressurePolicy::HelpDrain || worker;
+		uint32_t state = m_State.load(std::memory_order_acquire);
+		while ((state & COUNT_MASK) >= m_Capacity)
+		{
+			if (bHelp && m_HeldFunction)
+			{
+				RunHeldFunction();
+			}
+			else if (bHelp && worker && (worker->TryExecuteSpawnedTask(*this) || worker->TryExecuteTask()))
+			{
+			}
+			else
+			{
+				// Branches only wake a sleeping Wait, so this polls in slices
+				Platform::WaitOnAddress(m_State, state, std::chrono::steady_clock::now() + SpinPolicy::GetWorkerWaitSlice());
+			}
+			state = m_State.load(std::memory_order_acquire);
+		}
+		return true;
+	}
+
+	void TaskGroup::RunHeldFunction()
+	{
+		JobTask::TaskFunction function = std::move(m_HeldFunction);
+		m_HeldFunction = nullptr;
+		{
+			ScopedScratch scratch;
+			function();
+		}
+		OnBranchDone();
+	}
+
+	void TaskGroup::DispatchBranch(JobTask::TaskFunction&& function)
+	{
+		std::shared_ptr<JobTask> task = std::make_shared<JobTask>(std::move(function), m_Params);
+		task->SetTaskGroup(this);
+		m_Params.Scheduler->DispatchTask(std::move(task));
+	}
+
+	void TaskGroup::OnBranchDone()
+	{
+		const uint32_t prevState = m_State.fetch_sub(1, std::memory_order_acq_rel);
+		if ((prevState & COUNT_MASK) != 1 || (prevState & (WAITER_BIT | JOIN_BIT)) == 0)
+		{
+			return;
+		}
+		if (prevState & JOIN_BIT)
+		{
+			// Then published the task before setting the bit
+			JobTask::Launch(std::move(m_JoinTask), {});
+		}
+		if (prevState & WAITER_BIT)
+		{
+			Platform::WakeAllOnAddress(m_State);
+		}
+		// Last access, the owner returns from Wait once it sees this
+		m_bWakeDone.store(true, std::memory_order_release);
+	}
+}
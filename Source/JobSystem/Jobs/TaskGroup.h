@@ -0,0 +1,92 @@
+#pragma once
+#include "Core/Defines.h"
+#include "Jobs/Task.h"
+#include "Threading/ThreadTypes.h"
+
+#include <atomic>
+#include <functional>
+#include <type_traits>
+
+namespace SV
+{
+	enum class ETaskSpawnMode : uint8_t
+	{
+		// The newest branch is held back and run inline by Wait, earlier ones are queued as the next one is spawned.
+		// Suits spawning right before joining, as in recursive divide and conquer
+		WorkFirst,
+		// Every branch is queued right away, for spawners doing other work before they join
+		Queued
+	};
+
+	// Fork-join scope for branches joined by the spawning thread. Branches don't get events, the group counts them,
+	// so joining any number of them costs one atomic decrement each. On a worker, Wait pops the branches nobody stole
+	// back from the top of the local queue and runs them directly, only stolen ones are waited for. Only the thread
+	// that created the group spawns into it and waits. Branches cancelled at shutdown count as done.
+	class TaskGroup
+	{
+		NONCOPYABLE_NONMOVABLE(TaskGroup);
+	public:
+		explicit TaskGroup(ETaskSpawnMode mode = ETaskSpawnMode::WorkFirst, const TaskParams& params = TaskParams());
+		~TaskGroup(); // Waits for branches still running
+
+		// Bounds the outstanding branches, Spawn applies the policy once that many are in flight. 0 is unbounded.
+		// Block waits like HelpDrain on workers
+		void SetCapacity(uint32_t maxOutstanding, EBackpressurePolicy policy = EBackpressurePolicy::RunInline);
+		void Spawn(JobTask::TaskFunction&& function);
+		void Wait();
+		// Closes the group, the continuation is launched by whichever branch finishes last. Its event stands in
+		// for all branches as a single prerequisite. The group still has to outlive its branches, see Wait
+		std::shared_ptr<TaskEvent> Then(JobTask::TaskFunction&& continuation, const TaskParams& params = TaskParams());
+
+		bool IsDone() const { return (m_State.load(std::memory_order_acquire) & COUNT_MASK) == 0; }
+		uint32_t GetHighWaterMark() const { return m_HighWaterMark; }
+
+	private:
+		friend class WorkerThread;
+		friend class JobSystem;
+
+		// False if the policy ran the function instead
+		bool WaitForCapacity(JobTask::TaskFunction& function);
+
+		void RunHeldFunction();
+		void DispatchBranch(JobTask::TaskFunction&& function);
+		void OnBranchDone();
+
+	private:
+		static constexpr uint32_t WAITER_BIT = 1u << 31;
+		static constexpr uint32_t JOIN_BIT = 1u << 30; // Set by Then, the last branch launches m_JoinTask
+		static constexpr uint32_t COUNT_MASK = JOIN_BIT - 1;
+
+		TaskParams m_Params;
+		bool m_bRunNewestInline;
+		JobTask::TaskFunction m_HeldFunction;
+		std::shared_ptr<JobTask> m_JoinTask;
+		// Outstanding branches, the waiter bit is set while the owner sleeps on it
+		std::atomic<uint32_t> m_State{ 0 };
+		// Set once the last branch is done waking the owner or launching the join task
+		std::atomic<bool> m_bWakeDone{ false };
+
+		// Owner only
+		uint32_t m_Capacity = 0;
+		EBackpressurePolicy m_Policy = EBackpressurePolicy::RunInline;
+		uint32_t m_HighWaterMark = 0;
+	};
+
+	// Runs the functions in parallel and returns once all are done. The calling thread runs the last one inline
+	// and then whatever others no worker has stolen meanwhile
+	template<typename... Functions>
+	void ParallelInvoke(const TaskParams& params, Functions&&... functions)
+	{
+		static_assert(sizeof...(Functions) > 0, "ParallelInvoke needs at least one function");
+		TaskGroup group(ETaskSpawnMode::WorkFirst, params);
+		(group.Spawn(std::ref(functions)), ...);
+		group.Wait();
+	}
+
+	template<typename Function, typename... Functions>
+		requires (!std::is_same_v<std::decay_t<Function>, TaskParams>)
+	void ParallelInvoke(Function&& function, Functions&&... functions)
+	{
+		ParallelInvoke(TaskParams(), std::forward<Function>(function), std::forward<Functions>(functions)...);
+	}
+}
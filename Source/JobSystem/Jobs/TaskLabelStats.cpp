@@ -0,0 +1,268 @@
+#include "TaskLabelStats.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+
+namespace SV
+{
+	namespace
+	{
+
+		int64_t GetPercentile(const std::vector<uint64_t>& counts, uint64_t totalCount, int64_t maxNs, double percentile)
+		{
+			// Rank of the sample at the percentile, rounded up so p99 of 100 samples is the 99th
+			const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(percentile * static_cast<double>(totalCount) + 0.999999));
+			uint64_t seen = 0;
+			for (int32_t index = 0; index < static_cast<int32_t>(counts.size()); ++index)
+			{
+				seen += counts[index];
+				if (seen >= rank)
+				{
+					return std::min(LatencyHistogram::GetBucketUpperBound(index), maxNs);
+				}
+			}
+			return maxNs;
+		}
+
+		LatencySummary Summarize(const std::vector<uint64_t>& counts, int64_t maxNs)
+		{
+			LatencySummary summary;
+			for (uint64_t count : counts)
+			{
+				summary.Count += count;
+			}
+			if (summary.Count > 0)
+			{
+				summary.P50Ns = GetPercentile(counts, summary.Count, maxNs, 0.50);
+				summary.P99Ns = GetPercentile(counts, summary.Count, maxNs, 0.99);
+				summary.MaxNs = maxNs;
+			}
+			return summary;
+		}
+
+		double ToUs(int64_t ns)
+		{
+			return static_cast<double>(ns) / 1000.0;
+		}
+	}
+
+	void LatencyHistogram::Record(int64_t valueNs, bool bSingleWriter)
+	{
+		std::atomic<uint32_t>& count = m_Counts[GetBucketIndex(valueNs)];
+		int64_t maxNs = m_MaxNs.load(std::memory_order_relaxed);
+		if (bSingleWriter)
+		{
+			count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			if (valueNs > maxNs)
+			{
+				m_MaxNs.store(valueNs, std::memory_order_relaxed);
+			}
+			return;
+		}
+
+		count.fetch_add(1, std::memory_order_relaxed);
+		while (valueNs > maxNs && !m_MaxNs.compare_exchange_weak(maxNs, valueNs, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	void LatencyHistogram::AccumulateInto(std::vector<uint64_t>& outCounts, int64_t& inOutMaxNs) const
+	{
+		for (int32_t index = 0; index < BUCKET_COUNT; ++index)
+		{
+			outCounts[index] += m_Counts[index].load(std::memory_order_relaxed);
+		}
+		inOutMaxNs = std::max(inOutMaxNs, m_MaxNs.load(std::memory_order_relaxed));
+	}
+
+	void LatencyHistogram::Reset()
+	{
+		for (std::atomic<uint32_t>& count : m_Counts)
+		{
+			count.store(0, std::memory_order_relaxed);
+		}
+		m_MaxNs.store(0, std::memory_order_relaxed);
+	}
+
+	int32_t LatencyHistogram::GetBucketIndex(int64_t valueNs)
+	{
+		const uint64_t value = static_cast<uint64_t>(std::clamp<int64_t>(valueNs, 0, (int64_t(1) << MAX_VALUE_BITS) - 1));
+		if (value < SUB_BUCKET_COUNT)
+		{
+			return static_cast<int32_t>(value);
+		}
+		// Top SUB_BUCKET_BITS bits below the leading one pick the bucket within the power of two
+		const int32_t shift = std::bit_width(value) - 1 - SUB_BUCKET_BITS;
+		return (shift + 1) * SUB_BUCKET_COUNT + static_cast<int32_t>((value >> shift) - SUB_BUCKET_COUNT);
+	}
+
+	int64_t LatencyHistogram::GetBucketUpperBound(int32_t index)
+	{
+		if (index < SUB_BUCKET_COUNT)
+		{
+			return index;
+		}
+		const int32_t shift = index / SUB_BUCKET_COUNT - 1;
+		const int64_t subBucket = index % SUB_BUCKET_COUNT + SUB_BUCKET_COUNT;
+		return ((subBucket + 1) << shift) - 1;
+	}
+
+	TaskLabelStats::TaskLabelStats(int32_t workerCount)
+	{
+		m_Shards.resize(static_cast<size_t>(std::max(0, workerCount)) + 1);
+		for (std::unique_ptr<Shard>& shard : m_Shards)
+		{
+			shard = std::make_unique<Shard>();
+		}
+	}
+
+	TaskLabelStats::~TaskLabelStats()
+	{
+		for (std::unique_ptr<Shard>& shard : m_Shards)
+		{
+			for (std::atomic<LabelHistograms*>& histograms : shard->Labels)
+			{
+				delete histograms.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	void TaskLabelStats::Record(int32_t workerId, const char* label, int64_t queueLatencyNs, int64_t durationNs)
+	{
+		const int32_t labelIndex = FindOrAddLabel(label);
+		if (labelIndex < 0)
+		{
+			return;
+		}
+
+		const bool bWorkerShard = workerId >= 0 && static_cast<size_t>(workerId) + 1 < m_Shards.size();
+		const size_t shardIndex = bWorkerShard ? static_cast<size_t>(workerId) : m_Shards.size() - 1;
+		std::atomic<LabelHistograms*>& slot = m_Shards[shardIndex]->Labels[labelIndex];
+		LabelHistograms* histograms = slot.load(std::memory_order_acquire);
+		if (!histograms)
+		{
+			// Only the shared shard has competing writers, the loser of the race drops its copy
+			LabelHistograms* created = new LabelHistograms();
+			if (slot.compare_exchange_strong(histograms, created, std::memory_order_acq_rel))
+			{
+				histograms = created;
+			}
+			else
+			{
+				delete created;
+			}
+		}
+		// A worker shard is only written by its own worker
+		histograms->Duration.Record(durationNs, bWorkerShard);
+		histograms->QueueLatency.Record(queueLatencyNs, bWorkerShard);
+	}
+
+	int32_t TaskLabelStats::FindOrAddLabel(const char* label)
+	{
+		const size_t hash = std::hash<const char*>()(label);
+		for (int32_t probe = 0; probe < MAX_LABELS; ++probe)
+		{
+			const int32_t index = static_cast<int32_t>((hash + probe) % MAX_LABELS);
+			const char* slotLabel = m_LabelSlots[index].load(std::memory_order_acquire);
+			if (slotLabel == label)
+			{
+				return index;
+			}
+			if (!slotLabel)
+			{
+				if (m_LabelSlots[index].compare_exchange_strong(slotLabel, label, std::memory_order_acq_rel) || slotLabel == label)
+				{
+					return index;
+				}
+			}
+		}
+		return -1;
+	}
+
+	std::vector<TaskLabelReport> TaskLabelStats::GetReport() const
+	{
+		struct MergedLabel
+		{
+			const char* Label;
+			std::vector<uint64_t> DurationCounts;
+			std::vector<uint64_t> QueueCounts;
+			int64_t DurationMaxNs = 0;
+			int64_t QueueMaxNs = 0;
+		};
+
+		// Equal strings at different addresses, e.g. literals from different translation units, are merged
+		std::vector<MergedLabel> merged;
+		for (int32_t index = 0; index < MAX_LABELS; ++index)
+		{
+			const char* label = m_LabelSlots[index].load(std::memory_order_acquire);
+			if (!label)
+			{
+				continue;
+			}
+			auto it = std::find_if(merged.begin(), merged.end(), [label](const MergedLabel& entry) { return std::strcmp(entry.Label, label) == 0; });
+			if (it == merged.end())
+			{
+				merged.push_back({ label, std::vector<uint64_t>(LatencyHistogram::BUCKET_COUNT, 0), std::vector<uint64_t>(LatencyHistogram::BUCKET_COUNT, 0) });
+				it = merged.end() - 1;
+			}
+			for (const std::unique_ptr<Shard>& shard : m_Shards)
+			{
+				if (const LabelHistograms* histograms = shard->Labels[index].load(std::memory_order_acquire))
+				{
+					histograms->Duration.AccumulateInto(it->DurationCounts, it->DurationMaxNs);
+					histograms->QueueLatency.AccumulateInto(it->QueueCounts, it->QueueMaxNs);
+				}
+			}
+		}
+
+		std::vector<TaskLabelReport> report;
+		report.reserve(merged.size());
+		for (const MergedLabel& entry : merged)
+		{
+			TaskLabelReport labelReport{ entry.Label, Summarize(entry.DurationCounts, entry.DurationMaxNs), Summarize(entry.QueueCounts, entry.QueueMaxNs) };
+			if (labelReport.Duration.Count > 0)
+			{
+				report.push_back(std::move(labelReport));
+			}
+		}
+		std::sort(report.begin(), report.end(), [](const TaskLabelReport& a, const TaskLabelReport& b) { return a.Label < b.Label; });
+		return report;
+	}
+
+	void TaskLabelStats::Reset()
+	{
+		for (std::unique_ptr<Shard>& shard : m_Shards)
+		{
+			for (std::atomic<LabelHistograms*>& slot : shard->Labels)
+			{
+				if (LabelHistograms* histograms = slot.load(std::memory_order_acquire))
+				{
+					histograms->Duration.Reset();
+					histograms->QueueLatency.Reset();
+				}
+			}
+		}
+	}
+
+	void TaskLabelStats::PrintReport(const std::vector<TaskLabelReport>& report, std::ostream& stream)
+	{
+		const std::ios::fmtflags flags = stream.flags();
+		const std::streamsize precision = stream.precision();
+		stream << std::fixed << std::setprecision(1);
+		stream << "  " << std::left << std::setw(24) << "Label" << std::right << std::setw(10) << "Count"
+			<< std::setw(12) << "Run p50 us" << std::setw(12) << "p99" << std::setw(12) << "max"
+			<< std::setw(14) << "Queue p50 us" << std::setw(12) << "p99" << std::setw(12) << "max" << "\n";
+		for (const TaskLabelReport& entry : report)
+		{
+			stream << "  " << std::left << std::setw(24) << entry.Label << std::right << std::setw(10) << entry.Duration.Count
+				<< std::setw(12) << ToUs(entry.Duration.P50Ns) << std::setw(12) << ToUs(entry.Duration.P99Ns) << std::setw(12) << ToUs(entry.Duration.MaxNs)
+				<< std::setw(14) << ToUs(entry.QueueLatency.P50Ns) << std::setw(12) << ToUs(entry.QueueLatency.P99Ns) << std::setw(12) << ToUs(entry.QueueLatency.MaxNs) << "\n";
+		}
+		stream.flags(flags);
+		stream.precision(precision);
+	}
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include "Core/Defines.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace SV
+{
+	// Log-linear histogram of nanosecond values, 16 buckets per power of two keep every bucket within 6.25% of its
+	// values, like an HDR histogram with a bit over one significant digit. Values above ~18 minutes land in the last bucket.
+	// Recording is a few relaxed atomic operations, reads may run concurrently and see a slightly torn state
+	class LatencyHistogram
+	{
+	public:
+		static constexpr int32_t SUB_BUCKET_BITS = 4;
+		static constexpr int32_t SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+		static constexpr int32_t MAX_VALUE_BITS = 40;
+		static constexpr int32_t BUCKET_COUNT = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+		// bSingleWriter skips the read-modify-write instructions, only valid while one thread records
+		void Record(int64_t valueNs, bool bSingleWriter);
+		// Adds the counts to outCounts, sized BUCKET_COUNT
+		void AccumulateInto(std::vector<uint64_t>& outCounts, int64_t& inOutMaxNs) const;
+		void Reset();
+
+		static int32_t GetBucketIndex(int64_t valueNs);
+		// Largest value the bucket holds
+		static int64_t GetBucketUpperBound(int32_t index);
+
+	private:
+		std::array<std::atomic<uint32_t>, BUCKET_COUNT> m_Counts{};
+		std::atomic<int64_t> m_MaxNs{ 0 };
+	};
+
+	struct LatencySummary
+	{
+		uint64_t Count = 0;
+		int64_t P50Ns = 0;
+		int64_t P99Ns = 0;
+		int64_t MaxNs = 0;
+	};
+
+	struct TaskLabelReport
+	{
+		std::string Label;
+		LatencySummary Duration; // DoTask start to end
+		LatencySummary QueueLatency; // Ready to start, inline continuations count from their prerequisite completing
+	};
+
+	// Execution time and scheduling latency per task label. Labels are told apart by their pointer, so every label
+	// string has to outlive the job system, e.g. a string literal. Each worker records into its own shard, threads
+	// outside the workers share one more. Neither recording nor reporting takes a lock
+	class TaskLabelStats
+	{
+		NONCOPYABLE_NONMOVABLE(TaskLabelStats);
+	public:
+		static constexpr int32_t MAX_LABELS = 256; // Further labels are not recorded
+
+		explicit TaskLabelStats(int32_t workerCount);
+		~TaskLabelStats();
+
+		// workerId -1 for threads outside the workers
+		void Record(int32_t workerId, const char* label, int64_t queueLatencyNs, int64_t durationNs);
+
+		// One entry per label text with samples since the last Reset, sorted by label
+		std::vector<TaskLabelReport> GetReport() const;
+		// Samples recorded while resetting may be partially kept
+		void Reset();
+
+		static void PrintReport(const std::vector<TaskLabelReport>& report, std::ostream& stream);
+
+	private:
+		struct LabelHistograms
+		{
+			LatencyHistogram Duration;
+			LatencyHistogram QueueLatency;
+		};
+
+		struct alignas(64) Shard
+		{
+			std::array<std::atomic<LabelHistograms*>, MAX_LABELS> Labels{};
+		};
+
+		// Open addressing on the label pointer, slots are claimed once and never freed
+		int32_t FindOrAddLabel(const char* label);
+
+	private:
+		std::array<std::atomic<const char*>, MAX_LABELS> m_LabelSlots{};
+		std::vector<std::unique_ptr<Shard>> m_Shards; // Workers first, the shared shard last
+	};
+}
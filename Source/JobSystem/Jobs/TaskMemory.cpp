@@ -0,0 +1,35 @@
+#include "TaskMemory.h"
+#include "JobSystem.h"
+#include "WorkerThread.h"
+
+namespace SV
+{
+	TaskMemory::TaskMemory(const JobSystem* scheduler)
+		: m_Scheduler(scheduler)
+		, m_Scratch(SCRATCH_BLOCK_SIZE)
+		, m_Frame(FRAME_BLOCK_SIZE)
+	{
+	}
+
+	TaskMemory& TaskMemory::GetCurrent()
+	{
+		if (WorkerThread* worker = WorkerThread::GetCurrent())
+		{
+			return worker->GetTaskMemory();
+		}
+		static thread_local TaskMemory s_ThreadMemory(nullptr);
+		return s_ThreadMemory;
+	}
+
+	LinearAllocator& TaskMemory::GetFrame()
+	{
+		const JobSystem* scheduler = m_Scheduler ? m_Scheduler : JobSystem::TryGet();
+		const uint64_t frameIndex = scheduler ? scheduler->GetFrameIndex() : 0;
+		if (frameIndex != m_FrameIndex)
+		{
+			m_Frame.Reset();
+			m_FrameIndex = frameIndex;
+		}
+		return m_Frame;
+	}
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include "Core/Defines.h"
+#include "Core/LinearAllocator.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace SV
+{
+	class JobSystem;
+
+	// Scratch and frame allocators of a worker, threads outside the workers get their own set.
+	// Scratch memory lives until the task that allocated it returns. Frame memory lives until the job system
+	// begins a new frame, see JobSystem::BeginFrame. Neither may be handed to another thread past that point
+	class TaskMemory
+	{
+		NONCOPYABLE_NONMOVABLE(TaskMemory);
+	public:
+		static constexpr size_t SCRATCH_BLOCK_SIZE = 64 * 1024;
+		static constexpr size_t FRAME_BLOCK_SIZE = 256 * 1024;
+
+		// Null scheduler follows the default instance's frames
+		explicit TaskMemory(const JobSystem* scheduler);
+
+		// Memory of the running worker, or of the calling thread
+		static TaskMemory& GetCurrent();
+
+		template<typename T>
+		static T* AllocateScratch(size_t count = 1) { return GetCurrent().GetScratch().Allocate<T>(count); }
+		template<typename T>
+		static T* AllocateFrame(size_t count = 1) { return GetCurrent().GetFrame().Allocate<T>(count); }
+
+		LinearAllocator& GetScratch() { return m_Scratch; }
+		// Resets first if a new frame began since the last use
+		LinearAllocator& GetFrame();
+
+		size_t GetScratchHighWaterMark() const { return m_Scratch.GetHighWaterMark(); }
+		size_t GetFrameHighWaterMark() const { return m_Frame.GetHighWaterMark(); }
+
+	private:
+		const JobSystem* m_Scheduler;
+		LinearAllocator m_Scratch;
+		LinearAllocator m_Frame;
+		uint64_t m_FrameIndex = 0;
+	};
+
+	// Frees the scratch memory allocated during its lifetime, wraps every task body
+	class ScopedScratch
+	{
+		NONCOPYABLE_NONMOVABLE(ScopedScratch);
+	public:
+		ScopedScratch()
+			: m_Scratch(TaskMemory::GetCurrent().GetScratch())
+			, m_Marker(m_Scratch.GetMarker())
+		{}
+		~ScopedScratch() { m_Scratch.RewindTo(m_Marker); }
+
+	private:
+		LinearAllocator& m_Scratch;
+		LinearAllocator::Marker m_Marker;
+	};
+
+	template<typename T>
+	using ScratchVector = std::vector<T, LinearStlAllocator<T>>;
+
+	// Empty vector growing in the current scratch allocator
+	template<typename T>
+	ScratchVector<T> MakeScratchVector()
+	{
+		return ScratchVector<T>(LinearStlAllocator<T>(TaskMemory::GetCurrent().GetScratch()));
+	}
+}
@@ -0,0 +1,146 @@
+#include "TaskPipe.h"
+#include "JobSystem.h"
+#include "WorkerThread.h"
+
+#include <thread>
+#include <cassert>
+
+namespace SV
+{
+	static thread_local TaskPipe* s_CurrentPipe = nullptr;
+
+	TaskPipe::TaskPipe(const std::string& name, JobSystem* scheduler /*= nullptr*/)
+		: m_Name(name)
+		, m_Scheduler(scheduler)
+	{
+		Node* stub = new Node();
+		m_Head.store(stub, std::memory_order_relaxed);
+		m_Tail = stub;
+	}
+
+	TaskPipe::~TaskPipe()
+	{
+		WaitUntilEmpty();
+		assert(m_Tail == m_Head.load(std::memory_order_acquire) && "TaskPipe destroyed with queued tasks!");
+		delete m_Tail;
+	}
+
+	std::shared_ptr<TaskEvent> TaskPipe::Launch(JobTask::TaskFunction&& function, std::shared_ptr<TaskEvent> prerequisite /*= nullptr*/)
+	{
+		std::vector<std::shared_ptr<TaskEvent>> prerequisites;
+		if (prerequisite)
+		{
+			prerequisites.push_back(prerequisite);
+		}
+		return Launch(std::move(function), prerequisites);
+	}
+
+	std::shared_ptr<TaskEvent> TaskPipe::Launch(JobTask::TaskFunction&& function, const std::vector<std::shared_ptr<TaskEvent>>& prerequisites)
+	{
+		TaskParams params;
+		params.Scheduler = m_Scheduler;
+		std::shared_ptr<JobTask> task = std::make_shared<JobTask>(std::move(function), params);
+		task->SetPipe(this);
+		m_TaskCount.fetch_add(1, std::memory_order_relaxed);
+		return JobTask::Launch(std::move(task), prerequisites);
+	}
+
+	void TaskPipe::WaitUntilEmpty()
+	{
+		while (HasWork())
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	bool TaskPipe::IsInContext() const
+	{
+		return s_CurrentPipe == this;
+	}
+
+	void TaskPipe::PushReadyTask(std::shared_ptr<JobTask> task)
+	{
+		// The drain may pop the node as soon as it is linked
+		JobSystem* scheduler = &task->GetScheduler();
+		Node* node = new Node();
+		node->Task = std::move(task);
+
+		Node* prev = m_Head.exchange(node, std::memory_order_acq_rel);
+		prev->Next.store(node, std::memory_order_release);
+
+		// Only the producer that finds the pipe idle schedules the drain
+		if (m_ReadyCount.fetch_add(1, std::memory_order_acq_rel) == 0)
+		{
+			// Abandons the piped tasks itself on shutdown
+			TaskParams params;
+			params.Flags = ETaskFlags::NotCancellable;
+			params.Scheduler = scheduler;
+			scheduler->DispatchTask(std::make_shared<JobTask>([this]() { Execute(); }, params));
+		}
+	}
+
+	std::shared_ptr<JobTask> TaskPipe::PopReadyTask()
+	{
+		Node* tail = m_Tail;
+		Node* next = tail->Next.load(std::memory_order_acquire);
+		if (!next)
+		{
+			return nullptr;
+		}
+		m_Tail = next;
+		std::shared_ptr<JobTask> task = std::move(next->Task);
+		delete tail;
+		return task;
+	}
+
+	void TaskPipe::Execute()
+	{
+		TaskPipe* prevPipe = s_CurrentPipe;
+		s_CurrentPipe = this;
+
+		bool bHasMore = true;
+		while (bHasMore)
+		{
+			std::shared_ptr<JobTask> task = PopReadyTask();
+			while (!task)
+			{
+				// Producer has claimed the head but not linked the node yet
+				std::this_thread::yield();
+				task = PopReadyTask();
+			}
+
+			JobSystem& scheduler = task->GetScheduler();
+			const bool bCancelled = scheduler.IsCancellingTasks();
+			if (!bCancelled && scheduler.IsTaskTimed(*task))
+			{
+				const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+				task->DoTask();
+				WorkerThread* worker = scheduler.GetCurrentWorker();
+				scheduler.RecordTaskExecution(*task, worker ? worker->GetId() : -1, startTime, std::chrono::steady_clock::now());
+			}
+			else if (!bCancelled)
+			{
+				task->DoTask();
+			}
+			if (auto event = task->GetEvent())
+			{
+				if (bCancelled)
+				{
+					event->Abandon();
+				}
+				else
+				{
+					event->Complete();
+				}
+			}
+			task.reset();
+			scheduler.OnTaskRetired();
+
+			bHasMore = m_ReadyCount.fetch_sub(1, std::memory_order_acq_rel) > 1;
+			// The pipe may be destroyed right after the last task count drops to zero
+			m_TaskCount.fetch_sub(1, std::memory_order_release);
+		}
+
+		s_CurrentPipe = prevPipe;
+	}
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "Core/Defines.h"
+#include "Jobs/Task.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace SV
+{
+	// Executes launched tasks one at a time in FIFO order on any worker.
+	// Ready tasks are pushed to a lock-free MPSC queue, the first producer schedules a single
+	// drain job which keeps executing the backlog on the same worker until the pipe is empty.
+	// The pipe must outlive all tasks launched into it.
+	class TaskPipe
+	{
+		NONCOPYABLE_NONMOVABLE(TaskPipe);
+	public:
+		// Tasks run on the given scheduler, null picks the instance of each launching thread like TaskParams::Scheduler
+		explicit TaskPipe(const std::string& name, JobSystem* scheduler = nullptr);
+		~TaskPipe();
+
+		std::shared_ptr<TaskEvent> Launch(JobTask::TaskFunction&& function, std::shared_ptr<TaskEvent> prerequisite = nullptr);
+		std::shared_ptr<TaskEvent> Launch(JobTask::TaskFunction&& function, const std::vector<std::shared_ptr<TaskEvent>>& prerequisites);
+
+		// True if there are launched tasks that have not completed yet
+		bool HasWork() const
+		{
+			return m_TaskCount.load(std::memory_order_acquire) > 0;
+		}
+		void WaitUntilEmpty();
+
+		// True if called from a task executed by this pipe
+		bool IsInContext() const;
+
+		const std::string& GetName() const { return m_Name; }
+
+	private:
+		friend class JobSystem;
+
+		// Called by the job system once the task prerequisites are complete
+		void PushReadyTask(std::shared_ptr<JobTask> task);
+		void Execute();
+
+		struct Node
+		{
+			std::atomic<Node*> Next{ nullptr };
+			std::shared_ptr<JobTask> Task;
+		};
+
+		std::shared_ptr<JobTask> PopReadyTask();
+
+	private:
+		std::string m_Name;
+		JobSystem* m_Scheduler;
+
+		// Vyukov MPSC queue, m_Head is pushed by producers, m_Tail is owned by the draining worker
+		std::atomic<Node*> m_Head;
+		Node* m_Tail;
+
+		std::atomic<int32_t> m_ReadyCount{ 0 }; // Ready tasks not yet executed, 0 means no drain is scheduled
+		std::atomic<int32_t> m_TaskCount{ 0 }; // Launched tasks not yet completed
+	};
+}
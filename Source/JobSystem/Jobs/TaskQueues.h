@@ -2,87 +2,208 @@
 #include "Threading/ThreadTypes.h"
 #include "Threading/Synchronization.h"
 #include "Jobs/Task.h"
+#include "Platform/Platform.h"
 
 #include <deque>
-#include <mutex>
-#include <condition_variable>
+#include <vector>
+#include <algorithm>
 #include <memory>
 
 namespace SV
 {
+	// Min-heap on task deadline, guarded by the owning queue lock.
+	// The earliest deadline is mirrored in an atomic so thieves can compare queues without locking.
+	class TaskDeadlineHeap
+	{
+	public:
+		using TimePoint = std::chrono::steady_clock::time_point;
+
+		void Push(std::shared_ptr<JobTask> task)
+		{
+			m_Tasks.push_back(std::move(task));
+			std::push_heap(m_Tasks.begin(), m_Tasks.end(), &LaterDeadline);
+			UpdateEarliest();
+		}
+
+		std::shared_ptr<JobTask> Pop()
+		{
+			if (m_Tasks.empty())
+			{
+				return nullptr;
+			}
+			std::pop_heap(m_Tasks.begin(), m_Tasks.end(), &LaterDeadline);
+			std::shared_ptr<JobTask> task = std::move(m_Tasks.back());
+			m_Tasks.pop_back();
+			UpdateEarliest();
+			return task;
+		}
+
+		void Clear()
+		{
+			m_Tasks.clear();
+			UpdateEarliest();
+		}
+
+		bool IsEmpty() const { return m_Tasks.empty(); }
+		size_t Size() const { return m_Tasks.size(); }
+
+		TimePoint GetEarliest() const
+		{
+			return TimePoint(TimePoint::duration(m_EarliestDeadline.load(std::memory_order_relaxed)));
+		}
+
+	private:
+		static bool LaterDeadline(const std::shared_ptr<JobTask>& a, const std::shared_ptr<JobTask>& b)
+		{
+			return a->GetDeadline() > b->GetDeadline();
+		}
+
+		void UpdateEarliest()
+		{
+			TimePoint earliest = m_Tasks.empty() ? TimePoint::max() : m_Tasks.front()->GetDeadline();
+			m_EarliestDeadline.store(earliest.time_since_epoch().count(), std::memory_order_relaxed);
+		}
+
+	private:
+		std::vector<std::shared_ptr<JobTask>> m_Tasks;
+		std::atomic<TimePoint::rep> m_EarliestDeadline{ TimePoint::max().time_since_epoch().count() };
+	};
+
 	class TaskGlobalQueue : public ITaskQueue
 	{
 	public:
 		void Push(std::shared_ptr<JobTask> task) override
 		{
+			ScopedAdaptiveLock lock(m_Lock);
+			PushLocked(std::move(task));
+		}
+
+		bool TryPush(std::shared_ptr<JobTask>& task) override
+		{
+			ScopedAdaptiveLock lock(m_Lock);
+			if (m_Capacity != 0 && m_TaskQueue.size() + m_DeadlineTasks.Size() >= m_Capacity)
 			{
-				std::unique_lock<std::mutex> lock(m_Mutex);
-				m_TaskQueue.push_back(task);
+				return false;
 			}
-			m_Cv.notify_one();
+			PushLocked(std::move(task));
+			return true;
 		}
 		std::shared_ptr<JobTask> Pop() override
 		{
-			std::unique_lock<std::mutex> lock(m_Mutex);
-			if (m_TaskQueue.empty())
+			std::shared_ptr<JobTask> task;
 			{
-				return nullptr;
+				ScopedAdaptiveLock lock(m_Lock);
+				if (!m_DeadlineTasks.IsEmpty())
+				{
+					task = m_DeadlineTasks.Pop();
+				}
+				else if (!m_TaskQueue.empty())
+				{
+					task = std::move(m_TaskQueue.front());
+					m_TaskQueue.pop_front();
+				}
+			}
+			if (task)
+			{
+				NotifySpace();
 			}
-			std::shared_ptr<JobTask> task = m_TaskQueue.front();
-			m_TaskQueue.pop_front();
 			return task;
 		}
+
+		// Blocked producers sleep until a pop makes room or the deadline passes, the caller retries TryPush either way
+		void WaitForSpace(std::chrono::steady_clock::time_point deadline)
+		{
+			uint32_t sequence = m_PopSequence.load(std::memory_order_acquire);
+			m_SpaceWaiterCount.fetch_add(1, std::memory_order_seq_cst);
+			// Pairs with the fence in NotifySpace, either we see the room or the pop sees us waiting
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (Size() >= m_Capacity)
+			{
+				Platform::WaitOnAddress(m_PopSequence, sequence, deadline);
+			}
+			m_SpaceWaiterCount.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		// 0 is unbounded, set before the workers start
+		void SetCapacity(size_t capacity) { m_Capacity = capacity; }
+		size_t GetHighWaterMark() const override { return m_HighWaterMark.load(std::memory_order_relaxed); }
 		std::shared_ptr<JobTask> Steal() override { return nullptr; }
 
 		void Clear() override
 		{
-			std::lock_guard<std::mutex> lock(m_Mutex);
+			ScopedAdaptiveLock lock(m_Lock);
 			m_TaskQueue.clear();
+			m_DeadlineTasks.Clear();
 		}
 
 		bool IsEmpty() const override
 		{
-			std::lock_guard<std::mutex> lock(m_Mutex);
-			return m_TaskQueue.empty();
+			ScopedAdaptiveLock lock(m_Lock);
+			return m_TaskQueue.empty() && m_DeadlineTasks.IsEmpty();
 		}
 
 		size_t Size() const override
 		{
-			std::lock_guard<std::mutex> lock(m_Mutex);
-			return m_TaskQueue.size();
+			ScopedAdaptiveLock lock(m_Lock);
+			return m_TaskQueue.size() + m_DeadlineTasks.Size();
 		}
 
-		// Wait for a task to become available
-		std::shared_ptr<JobTask> WaitAndPop(std::atomic<bool>& stopFlag)
-		{
-			std::unique_lock<std::mutex> lock(m_Mutex);
+		std::chrono::steady_clock::time_point GetEarliestDeadline() const override { return m_DeadlineTasks.GetEarliest(); }
 
-			m_Cv.wait(lock, [this, &stopFlag]()
-				{
-					return !m_TaskQueue.empty() || stopFlag.load(std::memory_order_acquire);
-				});
-			if (stopFlag.load(std::memory_order_acquire))
+		std::shared_ptr<JobTask> PopEarliestDeadline() override
+		{
+			std::shared_ptr<JobTask> task;
 			{
-				return nullptr;
+				ScopedAdaptiveLock lock(m_Lock);
+				task = m_DeadlineTasks.Pop();
 			}
-			if (m_TaskQueue.empty())
+			if (task)
 			{
-				return nullptr;
+				NotifySpace();
 			}
-			auto task = std::move(m_TaskQueue.front());
-			m_TaskQueue.pop_front();
 			return task;
 		}
 
-		void NotifyAll()
+	private:
+		void PushLocked(std::shared_ptr<JobTask> task)
+		{
+			if (task->HasDeadline())
+			{
+				m_DeadlineTasks.Push(std::move(task));
+			}
+			else
+			{
+				m_TaskQueue.push_back(std::move(task));
+			}
+			const size_t size = m_TaskQueue.size() + m_DeadlineTasks.Size();
+			if (size > m_HighWaterMark.load(std::memory_order_relaxed))
+			{
+				m_HighWaterMark.store(size, std::memory_order_relaxed);
+			}
+		}
+
+		void NotifySpace()
 		{
-			m_Cv.notify_all();
+			if (m_Capacity == 0)
+			{
+				return;
+			}
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (m_SpaceWaiterCount.load(std::memory_order_relaxed) > 0)
+			{
+				m_PopSequence.fetch_add(1, std::memory_order_release);
+				Platform::WakeAllOnAddress(m_PopSequence);
+			}
 		}
 
 	private:
 		std::deque<std::shared_ptr<JobTask>> m_TaskQueue;
-		mutable std::mutex m_Mutex;
-		std::condition_variable m_Cv;
+		TaskDeadlineHeap m_DeadlineTasks;
+		mutable AdaptiveLock m_Lock;
+		size_t m_Capacity = 0;
+		std::atomic<size_t> m_HighWaterMark{ 0 };
+		std::atomic<uint32_t> m_PopSequence{ 0 };
+		std::atomic<int32_t> m_SpaceWaiterCount{ 0 };
 	};
 
 
@@ -92,14 +213,29 @@ namespace SV
 	public:
 		void Push(std::shared_ptr<JobTask> task) override
 		{
-			ScopedSpinLock lock(m_Lock);
-			m_TaskQueue.push_back(task);
+			ScopedAdaptiveLock lock(m_Lock);
+			PushLocked(std::move(task));
 		}
 
-		// Pop from back (LIFO for better cache locality)
+		bool TryPush(std::shared_ptr<JobTask>& task) override
+		{
+			ScopedAdaptiveLock lock(m_Lock);
+			if (m_Capacity != 0 && m_TaskQueue.size() + m_DeadlineTasks.Size() >= m_Capacity)
+			{
+				return false;
+			}
+			PushLocked(std::move(task));
+			return true;
+		}
+
+		// Pop from back (LIFO for better cache locality), deadline tasks first
 		std::shared_ptr<JobTask> Pop() override
 		{
-			ScopedSpinLock lock(m_Lock);
+			ScopedAdaptiveLock lock(m_Lock);
+			if (!m_DeadlineTasks.IsEmpty())
+			{
+				return m_DeadlineTasks.Pop();
+			}
 			if (m_TaskQueue.empty())
 			{
 				return nullptr;
@@ -109,10 +245,28 @@ namespace SV
 			return lastTask;
 		}
 
-		// Steal from front (FIFO to avoid contention with owner)
+		// Pops the newest task only if it matches, deadline tasks are left alone
+		template<typename Predicate>
+		std::shared_ptr<JobTask> PopIf(Predicate&& predicate)
+		{
+			ScopedAdaptiveLock lock(m_Lock);
+			if (m_TaskQueue.empty() || !predicate(*m_TaskQueue.back()))
+			{
+				return nullptr;
+			}
+			std::shared_ptr<JobTask> lastTask = std::move(m_TaskQueue.back());
+			m_TaskQueue.pop_back();
+			return lastTask;
+		}
+
+		// Steal from front (FIFO to avoid contention with owner), deadline tasks first
 		std::shared_ptr<JobTask> Steal() override
 		{
-			ScopedSpinLock lock(m_Lock);
+			ScopedAdaptiveLock lock(m_Lock);
+			if (!m_DeadlineTasks.IsEmpty())
+			{
+				return m_DeadlineTasks.Pop();
+			}
 			if (m_TaskQueue.empty())
 			{
 				return nullptr;
@@ -124,25 +278,143 @@ namespace SV
 
 		void Clear() override
 		{
-			ScopedSpinLock lock(m_Lock);
+			ScopedAdaptiveLock lock(m_Lock);
 			m_TaskQueue.clear();
+			m_DeadlineTasks.Clear();
 		}
 
 		bool IsEmpty() const override
 		{
-			ScopedSpinLock lock(const_cast<SpinLock&>(m_Lock));
-			return m_TaskQueue.empty();
+			ScopedAdaptiveLock lock(m_Lock);
+			return m_TaskQueue.empty() && m_DeadlineTasks.IsEmpty();
 		}
 
 		size_t Size() const override
 		{
-			ScopedSpinLock lock(const_cast<SpinLock&>(m_Lock));
-			return m_TaskQueue.size();
+			ScopedAdaptiveLock lock(m_Lock);
+			return m_TaskQueue.size() + m_DeadlineTasks.Size();
+		}
+
+		std::chrono::steady_clock::time_point GetEarliestDeadline() const override { return m_DeadlineTasks.GetEarliest(); }
+
+		std::shared_ptr<JobTask> PopEarliestDeadline() override
+		{
+			ScopedAdaptiveLock lock(m_Lock);
+			return m_DeadlineTasks.Pop();
+		}
+
+		// 0 is unbounded, set before the owning worker starts
+		void SetCapacity(size_t capacity) { m_Capacity = capacity; }
+		size_t GetHighWaterMark() const override { return m_HighWaterMark.load(std::memory_order_relaxed); }
+
+	private:
+		void PushLocked(std::shared_ptr<JobTask> task)
+		{
+			if (task->HasDeadline())
+			{
+				m_DeadlineTasks.Push(std::move(task));
+			}
+			else
+			{
+				m_TaskQueue.push_back(std::move(task));
+			}
+			const size_t size = m_TaskQueue.size() + m_DeadlineTasks.Size();
+			if (size > m_HighWaterMark.load(std::memory_order_relaxed))
+			{
+				m_HighWaterMark.store(size, std::memory_order_relaxed);
+			}
 		}
 
 	private:
 		std::deque<std::shared_ptr<JobTask>> m_TaskQueue;
-		SpinLock m_Lock;
+		TaskDeadlineHeap m_DeadlineTasks;
+		mutable AdaptiveLock m_Lock;
+		size_t m_Capacity = 0;
+		std::atomic<size_t> m_HighWaterMark{ 0 };
+	};
+
+	// Tasks targeted at one worker. The owner pops in push order,
+	// thieves only take tasks without hard affinity once they waited for the steal delay
+	class TaskMailbox
+	{
+	public:
+		void Push(std::shared_ptr<JobTask> task)
+		{
+			ScopedAdaptiveLock lock(m_Lock);
+			const bool bStealable = !task->HasFlags(ETaskFlags::HardAffinity);
+			m_Entries.push_back({ std::move(task), std::chrono::steady_clock::now() });
+			m_StealableCount.fetch_add(bStealable ? 1 : 0, std::memory_order_relaxed);
+			m_Count.fetch_add(1, std::memory_order_seq_cst);
+		}
+
+		std::shared_ptr<JobTask> Pop()
+		{
+			if (IsEmpty())
+			{
+				return nullptr;
+			}
+			ScopedAdaptiveLock lock(m_Lock);
+			if (m_Entries.empty())
+			{
+				return nullptr;
+			}
+			std::shared_ptr<JobTask> task = std::move(m_Entries.front().Task);
+			m_Entries.pop_front();
+			m_StealableCount.fetch_sub(task->HasFlags(ETaskFlags::HardAffinity) ? 0 : 1, std::memory_order_relaxed);
+			m_Count.fetch_sub(1, std::memory_order_relaxed);
+			return task;
+		}
+
+		std::shared_ptr<JobTask> Steal(std::chrono::steady_clock::duration stealDelay)
+		{
+			if (IsEmpty())
+			{
+				return nullptr;
+			}
+			ScopedAdaptiveLock lock(m_Lock);
+			const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+			for (auto it = m_Entries.begin(); it != m_Entries.end(); ++it)
+			{
+				if (now - it->PushTime < stealDelay)
+				{
+					// Entries are in push order, the rest are younger
+					break;
+				}
+				if (!it->Task->HasFlags(ETaskFlags::HardAffinity))
+				{
+					std::shared_ptr<JobTask> task = std::move(it->Task);
+					m_Entries.erase(it);
+					m_StealableCount.fetch_sub(1, std::memory_order_relaxed);
+					m_Count.fetch_sub(1, std::memory_order_relaxed);
+					return task;
+				}
+			}
+			return nullptr;
+		}
+
+		void Clear()
+		{
+			ScopedAdaptiveLock lock(m_Lock);
+			m_Entries.clear();
+			m_StealableCount.store(0, std::memory_order_relaxed);
+			m_Count.store(0, std::memory_order_relaxed);
+		}
+
+		bool IsEmpty() const { return m_Count.load(std::memory_order_seq_cst) == 0; }
+		size_t Size() const { return static_cast<size_t>(m_Count.load(std::memory_order_relaxed)); }
+		bool HasStealable() const { return m_StealableCount.load(std::memory_order_relaxed) > 0; }
+
+	private:
+		struct Entry
+		{
+			std::shared_ptr<JobTask> Task;
+			std::chrono::steady_clock::time_point PushTime;
+		};
+
+		std::deque<Entry> m_Entries;
+		std::atomic<int32_t> m_Count{ 0 };
+		std::atomic<int32_t> m_StealableCount{ 0 };
+		mutable AdaptiveLock m_Lock;
 	};
 
 }
\ No newline at end of file
@@ -0,0 +1,330 @@
+#include "TaskSynchronization.h"
+#include "JobSystem.h"
+#include "WorkerThread.h"
+#include "SpinPolicy.h"
+#include "Platform/Platform.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace SV
+{
+	namespace
+	{
+		// Every helped task may wait in turn, bounds how deep a worker stack can nest
+		constexpr int32_t MAX_HELP_DEPTH = 16;
+
+		thread_local int32_t s_HelpDepth = 0;
+		thread_local int32_t s_HeldTaskMutexCount = 0;
+
+		bool CanHelp(WorkerThread* worker)
+		{
+			return worker && s_HeldTaskMutexCount == 0 && s_HelpDepth < MAX_HELP_DEPTH;
+		}
+
+		bool HelpOnce(WorkerThread& worker)
+		{
+			++s_HelpDepth;
+			bool bExecuted = worker.TryExecuteTask();
+			--s_HelpDepth;
+			return bExecuted;
+		}
+	}
+
+	TaskSemaphore::TaskSemaphore(int32_t initialCount)
+		: m_Count(initialCount)
+	{
+	}
+
+	bool TaskSemaphore::TryAcquire()
+	{
+		int32_t count = m_Count.load(std::memory_order_relaxed);
+		while (count > 0)
+		{
+			if (m_Count.compare_exchange_weak(count, count - 1, std::memory_order_acquire, std::memory_order_relaxed))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void TaskSemaphore::Acquire()
+	{
+		AcquireUntil(std::chrono::steady_clock::time_point::max());
+	}
+
+	bool TaskSemaphore::AcquireUntil(std::chrono::steady_clock::time_point deadline)
+	{
+		if (TryAcquire())
+		{
+			return true;
+		}
+
+		WorkerThread* worker = WorkerThread::GetCurrent();
+		const bool bCanHelp = CanHelp(worker);
+
+		// Queued tasks first, the holder usually releases within a few of them
+		AdaptiveSpinBudget& spinBudget = SpinPolicy::GetWaitBudget();
+		const uint32_t maxSpinCount = spinBudget.Get();
+		for (uint32_t spinCount = 0; spinCount < maxSpinCount; )
+		{
+			if (TryAcquire())
+			{
+				if (spinCount > 0)
+				{
+					spinBudget.RecordOutcome(spinCount, true);
+				}
+				return true;
+			}
+			if (std::chrono::steady_clock::now() >= deadline)
+			{
+				return false;
+			}
+			if (bCanHelp && HelpOnce(*worker))
+			{
+				continue;
+			}
+			++spinCount;
+			Platform::CpuPause();
+		}
+
+		// Nothing to run, let a spare worker cover while this one sleeps
+		spinBudget.RecordOutcome(maxSpinCount, false);
+		ScopedBlockingRegion blockingRegion;
+		for (;;)
+		{
+			uint32_t sequence = m_ReleaseSequence.load(std::memory_order_acquire);
+			m_SleeperCount.fetch_add(1, std::memory_order_seq_cst);
+			// Pairs with the fence in Release, either we see the unit or Release sees us sleeping
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			bool bAcquired = TryAcquire();
+			if (!bAcquired)
+			{
+				// Workers wake up regularly to run tasks queued meanwhile
+				Platform::WaitOnAddress(m_ReleaseSequence, sequence, worker ? std::min(deadline, std::chrono::steady_clock::now() + SpinPolicy::GetWorkerWaitSlice()) : deadline);
+			}
+			m_SleeperCount.fetch_sub(1, std::memory_order_relaxed);
+
+			if (bAcquired || TryAcquire())
+			{
+				return true;
+			}
+			if (std::chrono::steady_clock::now() >= deadline)
+			{
+				return false;
+			}
+			while (bCanHelp && HelpOnce(*worker))
+			{
+				if (TryAcquire())
+				{
+					return true;
+				}
+			}
+		}
+	}
+
+	void TaskSemaphore::Release(int32_t count /*= 1*/)
+	{
+		m_Count.fetch_add(count, std::memory_order_release);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		if (m_HeldTaskCount.load(std::memory_order_relaxed) > 0)
+		{
+			DispatchHeldTasks();
+		}
+		if (m_SleeperCount.load(std::memory_order_relaxed) > 0)
+		{
+			m_ReleaseSequence.fetch_add(1, std::memory_order_release);
+			if (count == 1)
+			{
+				Platform::WakeOneOnAddress(m_ReleaseSequence);
+			}
+			else
+			{
+				Platform::WakeAllOnAddress(m_ReleaseSequence);
+			}
+		}
+	}
+
+	std::shared_ptr<TaskEvent> TaskSemaphore::Launch(JobTask::TaskFunction&& function, const TaskParams& params /*= TaskParams()*/)
+	{
+		std::shared_ptr<JobTask> task = std::make_shared<JobTask>([this, function = std::move(function)]()
+			{
+				function();
+				Release();
+			}, params);
+		std::shared_ptr<TaskEvent> taskEvent = std::make_shared<TaskEvent>();
+		task->SetEvent(taskEvent);
+
+		// Earlier held tasks keep their turn
+		if (m_HeldTaskCount.load(std::memory_order_relaxed) == 0 && TryAcquire())
+		{
+			return JobTask::Launch(std::move(task), {});
+		}
+
+		{
+			ScopedAdaptiveLock lock(m_HeldTasksLock);
+			m_HeldTasks.push_back(std::move(task));
+			m_HeldTaskCount.fetch_add(1, std::memory_order_relaxed);
+		}
+		// Pairs with the fence in Release, a unit released meanwhile is picked up here
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		DispatchHeldTasks();
+		return taskEvent;
+	}
+
+	void TaskSemaphore::DispatchHeldTasks()
+	{
+		std::vector<std::shared_ptr<JobTask>> readyTasks;
+		{
+			ScopedAdaptiveLock lock(m_HeldTasksLock);
+			while (!m_HeldTasks.empty() && TryAcquire())
+			{
+				readyTasks.push_back(std::move(m_HeldTasks.front()));
+				m_HeldTasks.pop_front();
+				m_HeldTaskCount.fetch_sub(1, std::memory_order_relaxed);
+			}
+		}
+		for (std::shared_ptr<JobTask>& task : readyTasks)
+		{
+			JobTask::Launch(std::move(task), {});
+		}
+	}
+
+	bool TaskMutex::TryLock()
+	{
+		if (!m_Semaphore.TryAcquire())
+		{
+			return false;
+		}
+		++s_HeldTaskMutexCount;
+		return true;
+	}
+
+	void TaskMutex::Lock()
+	{
+		LockUntil(std::chrono::steady_clock::time_point::max());
+	}
+
+	bool TaskMutex::LockUntil(std::chrono::steady_clock::time_point deadline)
+	{
+		if (!m_Semaphore.AcquireUntil(deadline))
+		{
+			return false;
+		}
+		++s_HeldTaskMutexCount;
+		return true;
+	}
+
+	void TaskMutex::Unlock()
+	{
+		--s_HeldTaskMutexCount;
+		m_Semaphore.Release();
+	}
+
+	std::shared_ptr<TaskEvent> TaskMutex::Launch(JobTask::TaskFunction&& function, const TaskParams& params /*= TaskParams()*/)
+	{
+		return m_Semaphore.Launch([function = std::move(function)]()
+			{
+				++s_HeldTaskMutexCount;
+				function();
+				--s_HeldTaskMutexCount;
+			}, params);
+	}
+
+	TaskLatch::TaskLatch(int32_t count)
+		: m_Count(count)
+		, m_Event(std::make_shared<TaskEvent>())
+	{
+		if (count <= 0)
+		{
+			m_Event->Complete();
+		}
+	}
+
+	void TaskLatch::CountDown(int32_t count /*= 1*/)
+	{
+		// The waiter may destroy the latch as soon as the event completes
+		std::shared_ptr<TaskEvent> event = m_Event;
+		int32_t previous = m_Count.fetch_sub(count, std::memory_order_acq_rel);
+		if (previous > 0 && previous <= count)
+		{
+			event->Complete();
+		}
+	}
+
+	TaskBarrier::TaskBarrier(int32_t participantCount, std::function<void()> onPhaseComplete /*= nullptr*/)
+		: m_ParticipantCount(participantCount)
+		, m_PhaseEvent(std::make_shared<TaskEvent>())
+		, m_OnPhaseComplete(std::move(onPhaseComplete))
+	{
+	}
+
+	void TaskBarrier::ArriveAndWait()
+	{
+		uint32_t phase = 0;
+		std::shared_ptr<TaskEvent> phaseEvent = ArriveInternal(false, &phase);
+		AdaptiveSpinBudget& spinBudget = SpinPolicy::GetWaitBudget();
+		const uint32_t maxSpinCount = spinBudget.Get();
+		for (uint32_t spinCount = 0; spinCount < maxSpinCount; ++spinCount)
+		{
+			if (phaseEvent->IsComplete())
+			{
+				if (spinCount > 0)
+				{
+					spinBudget.RecordOutcome(spinCount, true);
+				}
+				return;
+			}
+			Platform::CpuPause();
+		}
+		spinBudget.RecordOutcome(maxSpinCount, false);
+
+		ScopedBlockingRegion blockingRegion;
+		while (m_Phase.load(std::memory_order_acquire) == phase)
+		{
+			Platform::WaitOnAddress(m_Phase, phase);
+		}
+	}
+
+	std::shared_ptr<TaskEvent> TaskBarrier::ArriveInternal(bool bDrop, uint32_t* outPhase)
+	{
+		std::shared_ptr<TaskEvent> phaseEvent;
+		bool bLastArrival = false;
+		{
+			ScopedAdaptiveLock lock(m_Lock);
+			phaseEvent = m_PhaseEvent;
+			if (outPhase)
+			{
+				*outPhase = m_Phase.load(std::memory_order_relaxed);
+			}
+			if (bDrop)
+			{
+				m_ParticipantCount--;
+			}
+			else
+			{
+				m_ArrivedCount++;
+			}
+			bLastArrival = m_ArrivedCount >= m_ParticipantCount;
+			if (bLastArrival)
+			{
+				m_ArrivedCount = 0;
+				m_PhaseEvent = std::make_shared<TaskEvent>();
+			}
+		}
+
+		if (bLastArrival)
+		{
+			if (m_OnPhaseComplete)
+			{
+				m_OnPhaseComplete();
+			}
+			m_Phase.fetch_add(1, std::memory_order_release);
+			Platform::WakeAllOnAddress(m_Phase);
+			phaseEvent->Complete();
+		}
+		return phaseEvent;
+	}
+}
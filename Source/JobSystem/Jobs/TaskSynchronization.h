@@ -0,0 +1,149 @@
+#pragma once
+#include "Core/Defines.h"
+#include "Jobs/Task.h"
+#include "Threading/Synchronization.h"
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+
+namespace SV
+{
+	// Synchronization for job bodies that doesn't take workers out of the pool.
+	// Blocking calls made on a worker run other queued tasks while they wait, and once there is nothing to run they sleep
+	// in a blocking region so a spare worker keeps the group busy. The Launch/Arrive/GetEvent forms don't wait at all,
+	// the follow up work is held by the primitive as a task and dispatched once it may run.
+	// Primitives must outlive the tasks launched through them.
+
+	// Counting semaphore. Units are not owned, any thread may release them
+	class TaskSemaphore
+	{
+		NONCOPYABLE_NONMOVABLE(TaskSemaphore);
+	public:
+		explicit TaskSemaphore(int32_t initialCount);
+
+		bool TryAcquire();
+		void Acquire();
+		bool AcquireUntil(std::chrono::steady_clock::time_point deadline); // Returns false on timeout
+		template<typename Rep, typename Period>
+		bool AcquireFor(const std::chrono::duration<Rep, Period>& timeout)
+		{
+			return AcquireUntil(std::chrono::steady_clock::now() + timeout);
+		}
+		void Release(int32_t count = 1);
+
+		// Holds the task in the semaphore until a unit is free, it runs owning that unit and releases it when done
+		std::shared_ptr<TaskEvent> Launch(JobTask::TaskFunction&& function, const TaskParams& params = TaskParams());
+
+		int32_t GetAvailableCount() const { return m_Count.load(std::memory_order_relaxed); }
+
+	private:
+		void DispatchHeldTasks();
+
+	private:
+		std::atomic<int32_t> m_Count;
+
+		// Sleeping waiters wait for the sequence to change, Release only bumps it when someone sleeps
+		std::atomic<uint32_t> m_ReleaseSequence{ 0 };
+		std::atomic<int32_t> m_SleeperCount{ 0 };
+
+		std::atomic<int32_t> m_HeldTaskCount{ 0 };
+		std::deque<std::shared_ptr<JobTask>> m_HeldTasks;
+		AdaptiveLock m_HeldTasksLock;
+	};
+
+	// Non-recursive mutex. A thread holding one doesn't run other tasks while waiting on another TaskMutex or TaskSemaphore,
+	// a nested task taking the same mutex would deadlock against its own thread. TaskEvent waits still do, so don't
+	// wait for other tasks while holding the lock
+	class TaskMutex
+	{
+		NONCOPYABLE_NONMOVABLE(TaskMutex);
+	public:
+		TaskMutex() = default;
+
+		bool TryLock();
+		void Lock();
+		bool LockUntil(std::chrono::steady_clock::time_point deadline); // Returns false on timeout
+		void Unlock();
+
+		// Runs the task holding the lock, it waits in the mutex instead of on a worker
+		std::shared_ptr<TaskEvent> Launch(JobTask::TaskFunction&& function, const TaskParams& params = TaskParams());
+
+	private:
+		TaskSemaphore m_Semaphore{ 1 };
+	};
+
+	class ScopedTaskLock
+	{
+	public:
+		explicit ScopedTaskLock(TaskMutex& mutex) : m_Mutex(mutex)
+		{
+			m_Mutex.Lock();
+		}
+		~ScopedTaskLock()
+		{
+			m_Mutex.Unlock();
+		}
+		ScopedTaskLock(const ScopedTaskLock&) = delete;
+		ScopedTaskLock& operator=(const ScopedTaskLock&) = delete;
+	private:
+		TaskMutex& m_Mutex;
+	};
+
+	// Single use countdown
+	class TaskLatch
+	{
+		NONCOPYABLE_NONMOVABLE(TaskLatch);
+	public:
+		explicit TaskLatch(int32_t count);
+
+		void CountDown(int32_t count = 1);
+		bool TryWait() const { return m_Event->IsComplete(); }
+		void Wait() { m_Event->Wait(); }
+		bool WaitUntil(std::chrono::steady_clock::time_point deadline) { return m_Event->WaitUntil(deadline); }
+		void ArriveAndWait(int32_t count = 1)
+		{
+			CountDown(count);
+			Wait();
+		}
+
+		// Completes once the count reaches zero, a prerequisite for work that should follow without anyone waiting
+		const std::shared_ptr<TaskEvent>& GetEvent() const { return m_Event; }
+
+	private:
+		std::atomic<int32_t> m_Count;
+		std::shared_ptr<TaskEvent> m_Event;
+	};
+
+	// Reusable phase barrier. The phase completion function runs on the last arriving thread before anyone is released.
+	// ArriveAndWait doesn't run other tasks, a nested participant would wait for the next phase on top of one still
+	// owing its arrival. It sleeps in a blocking region instead, so up to workers + spares participants can wait at once.
+	// With more participants than that, continue through the event returned by Arrive
+	class TaskBarrier
+	{
+		NONCOPYABLE_NONMOVABLE(TaskBarrier);
+	public:
+		explicit TaskBarrier(int32_t participantCount, std::function<void()> onPhaseComplete = nullptr);
+
+		// Returns the event of the current phase, tasks depending on it continue once every participant arrived
+		std::shared_ptr<TaskEvent> Arrive() { return ArriveInternal(false, nullptr); }
+		void ArriveAndWait();
+		// Arrives and leaves, later phases expect one participant less
+		void ArriveAndDrop() { ArriveInternal(true, nullptr); }
+
+		uint32_t GetPhase() const { return m_Phase.load(std::memory_order_acquire); }
+
+	private:
+		std::shared_ptr<TaskEvent> ArriveInternal(bool bDrop, uint32_t* outPhase);
+
+	private:
+		AdaptiveLock m_Lock;
+		int32_t m_ParticipantCount;
+		int32_t m_ArrivedCount = 0;
+		std::atomic<uint32_t> m_Phase{ 0 }; // Futex word for ArriveAndWait
+		std::shared_ptr<TaskEvent> m_PhaseEvent;
+		std::function<void()> m_OnPhaseComplete;
+	};
+}
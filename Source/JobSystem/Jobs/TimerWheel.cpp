@@ -0,0 +1,203 @@
+#include "TimerWheel.h"
+#include "Task.h"
+
+#include <algorithm>
+
+namespace SV
+{
+	TimerWheel::TimerWheel()
+		: m_StartTime(Clock::now())
+	{
+	}
+
+	TimerHandle TimerWheel::Schedule(Clock::time_point time, std::shared_ptr<JobTask> task)
+	{
+		Timer timer;
+		timer.Task = std::move(task);
+		timer.Cancelled = std::make_shared<std::atomic<bool>>(false);
+		TimerHandle handle(timer.Cancelled);
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		timer.ExpiryTick = ToTick(time);
+		Insert(std::move(timer));
+		m_TimerCount.fetch_add(1, std::memory_order_release);
+		return handle;
+	}
+
+	TimerHandle TimerWheel::SchedulePeriodic(Clock::time_point firstTime, Clock::duration period, std::function<void()>&& function)
+	{
+		Timer timer;
+		timer.PeriodTicks = std::max<uint64_t>(1, static_cast<uint64_t>((period + TICK - Clock::duration(1)) / TICK));
+		timer.Function = std::make_shared<std::function<void()>>(std::move(function));
+		timer.Cancelled = std::make_shared<std::atomic<bool>>(false);
+		TimerHandle handle(timer.Cancelled);
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		timer.ExpiryTick = ToTick(firstTime);
+		Insert(std::move(timer));
+		m_TimerCount.fetch_add(1, std::memory_order_release);
+		return handle;
+	}
+
+	void TimerWheel::CancelAll(std::vector<std::shared_ptr<JobTask>>& outPending)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		auto collect = [&outPending](std::vector<Timer>& timers)
+			{
+				for (Timer& timer : timers)
+				{
+					timer.Cancelled->store(true, std::memory_order_release);
+					if (timer.Task)
+					{
+						outPending.push_back(std::move(timer.Task));
+					}
+				}
+				timers.clear();
+			};
+
+		for (auto& level : m_Slots)
+		{
+			for (std::vector<Timer>& slot : level)
+			{
+				collect(slot);
+			}
+		}
+		collect(m_Overflow);
+		m_TimerCount.store(0, std::memory_order_release);
+	}
+
+	void TimerWheel::Advance(Clock::time_point now, std::vector<std::shared_ptr<JobTask>>& outExpired)
+	{
+		uint64_t targetTick = static_cast<uint64_t>((now - m_StartTime) / TICK);
+		if (targetTick <= m_CurrentTick.load(std::memory_order_acquire))
+		{
+			return;
+		}
+
+		std::unique_lock<std::mutex> lock(m_Mutex, std::try_to_lock);
+		if (!lock.owns_lock())
+		{
+			return;
+		}
+
+		uint64_t currentTick = m_CurrentTick.load(std::memory_order_relaxed);
+		if (m_TimerCount.load(std::memory_order_acquire) == 0)
+		{
+			// Nothing to cascade, jump straight to the target
+			m_CurrentTick.store(std::max(currentTick, targetTick), std::memory_order_release);
+			return;
+		}
+
+		while (currentTick < targetTick)
+		{
+			currentTick++;
+			m_CurrentTick.store(currentTick, std::memory_order_release);
+
+			// Higher levels first, they may drop timers into the lower level slot being cascaded
+			for (uint32_t level = LEVEL_COUNT - 1; level > 0; --level)
+			{
+				if ((currentTick & ((1ull << (SLOT_BITS * level)) - 1)) == 0)
+				{
+					Cascade(level);
+				}
+			}
+			ExpireCurrentSlot(outExpired);
+		}
+	}
+
+	TimerWheel::Clock::time_point TimerWheel::GetNextTickTime() const
+	{
+		return m_StartTime + TICK * static_cast<int64_t>(m_CurrentTick.load(std::memory_order_acquire) + 1);
+	}
+
+	uint64_t TimerWheel::ToTick(Clock::time_point time) const
+	{
+		if (time <= m_StartTime)
+		{
+			return 0;
+		}
+		// Round up so timers never fire early
+		return static_cast<uint64_t>((time - m_StartTime + TICK - Clock::duration(1)) / TICK);
+	}
+
+	void TimerWheel::Insert(Timer&& timer)
+	{
+		uint64_t currentTick = m_CurrentTick.load(std::memory_order_relaxed);
+		uint64_t expiryTick = std::max(timer.ExpiryTick, currentTick + 1);
+		uint64_t delta = expiryTick - currentTick;
+
+		for (uint32_t level = 0; level < LEVEL_COUNT; ++level)
+		{
+			if (delta < (1ull << (SLOT_BITS * (level + 1))))
+			{
+				uint64_t slot = (expiryTick >> (SLOT_BITS * level)) & SLOT_MASK;
+				m_Slots[level][slot].push_back(std::move(timer));
+				return;
+			}
+		}
+		m_Overflow.push_back(std::move(timer));
+	}
+
+	void TimerWheel::Cascade(uint32_t level)
+	{
+		uint64_t currentTick = m_CurrentTick.load(std::memory_order_relaxed);
+		uint64_t slot = (currentTick >> (SLOT_BITS * level)) & SLOT_MASK;
+
+		std::vector<Timer> timers = std::move(m_Slots[level][slot]);
+		m_Slots[level][slot].clear();
+		if (level == LEVEL_COUNT - 1)
+		{
+			std::vector<Timer> overflow = std::move(m_Overflow);
+			m_Overflow.clear();
+			for (Timer& timer : overflow)
+			{
+				timers.push_back(std::move(timer));
+			}
+		}
+
+		for (Timer& timer : timers)
+		{
+			// Due on this tick, Insert would push it to the next one. The current slot expires right after the cascade
+			if (timer.ExpiryTick <= currentTick)
+			{
+				m_Slots[0][currentTick & SLOT_MASK].push_back(std::move(timer));
+				continue;
+			}
+			Insert(std::move(timer));
+		}
+	}
+
+	void TimerWheel::ExpireCurrentSlot(std::vector<std::shared_ptr<JobTask>>& outExpired)
+	{
+		uint64_t currentTick = m_CurrentTick.load(std::memory_order_relaxed);
+		std::vector<Timer> timers = std::move(m_Slots[0][currentTick & SLOT_MASK]);
+		m_Slots[0][currentTick & SLOT_MASK].clear();
+
+		for (Timer& timer : timers)
+		{
+			if (timer.Cancelled->load(std::memory_order_acquire))
+			{
+				m_TimerCount.fetch_sub(1, std::memory_order_release);
+				continue;
+			}
+
+			if (timer.PeriodTicks == 0)
+			{
+				outExpired.push_back(std::move(timer.Task));
+				m_TimerCount.fetch_sub(1, std::memory_order_release);
+				continue;
+			}
+
+			std::shared_ptr<std::function<void()>> function = timer.Function;
+			outExpired.push_back(std::make_shared<JobTask>([function]() { (*function)(); }));
+
+			// Fixed rate, skip missed periods instead of firing a burst
+			timer.ExpiryTick += timer.PeriodTicks;
+			if (timer.ExpiryTick <= currentTick)
+			{
+				timer.ExpiryTick = currentTick + timer.PeriodTicks;
+			}
+			Insert(std::move(timer));
+		}
+	}
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include "Core/Defines.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace SV
+{
+	class JobTask;
+
+	class TimerHandle
+	{
+	public:
+		TimerHandle() = default;
+
+		// Stops further expirations, an already dispatched task still runs
+		void Cancel()
+		{
+			if (m_Cancelled)
+			{
+				m_Cancelled->store(true, std::memory_order_release);
+			}
+		}
+
+		bool IsValid() const { return m_Cancelled && !m_Cancelled->load(std::memory_order_acquire); }
+
+	private:
+		friend class TimerWheel;
+		explicit TimerHandle(std::shared_ptr<std::atomic<bool>> cancelled)
+			: m_Cancelled(std::move(cancelled))
+		{}
+
+		std::shared_ptr<std::atomic<bool>> m_Cancelled;
+	};
+
+	// Hierarchical timing wheel, 4 levels of 64 slots with 100us ticks (~28 minutes before overflow).
+	// Serviced by idle workers, expired timers are returned as tasks to be pushed into the normal queues.
+	class TimerWheel
+	{
+		NONCOPYABLE_NONMOVABLE(TimerWheel);
+	public:
+		using Clock = std::chrono::steady_clock;
+		static constexpr Clock::duration TICK = std::chrono::microseconds(100);
+
+		TimerWheel();
+		~TimerWheel() = default;
+
+		// One-shot, the task is returned from Advance once time is reached
+		TimerHandle Schedule(Clock::time_point time, std::shared_ptr<JobTask> task);
+		// Periodic, a new task invoking the function is returned on every expiration. Runs may overlap
+		TimerHandle SchedulePeriodic(Clock::time_point firstTime, Clock::duration period, std::function<void()>&& function);
+
+		// Collects expired tasks, returns immediately if another thread is advancing or no tick has passed
+		void Advance(Clock::time_point now, std::vector<std::shared_ptr<JobTask>>& outExpired);
+
+		// Removes every timer, returns the tasks of pending one-shot timers so their events can be abandoned
+		void CancelAll(std::vector<std::shared_ptr<JobTask>>& outPending);
+
+		bool IsEmpty() const { return m_TimerCount.load(std::memory_order_acquire) == 0; }
+		Clock::time_point GetNextTickTime() const;
+
+	private:
+		struct Timer
+		{
+			uint64_t ExpiryTick = 0;
+			uint64_t PeriodTicks = 0; // 0 for one-shot timers
+			std::shared_ptr<JobTask> Task;
+			std::shared_ptr<std::function<void()>> Function;
+			std::shared_ptr<std::atomic<bool>> Cancelled;
+		};
+
+		static constexpr uint32_t LEVEL_COUNT = 4;
+		static constexpr uint32_t SLOT_BITS = 6;
+		static constexpr uint32_t SLOT_COUNT = 1u << SLOT_BITS;
+		static constexpr uint64_t SLOT_MASK = SLOT_COUNT - 1;
+
+		uint64_t ToTick(Clock::time_point time) const;
+		void Insert(Timer&& timer);
+		void Cascade(uint32_t level);
+		void ExpireCurrentSlot(std::vector<std::shared_ptr<JobTask>>& outExpired);
+
+	private:
+		Clock::time_point m_StartTime;
+		std::atomic<uint64_t> m_CurrentTick{ 0 };
+		std::atomic<int32_t> m_TimerCount{ 0 };
+
+		std::array<std::array<std::vector<Timer>, SLOT_COUNT>, LEVEL_COUNT> m_Slots;
+		std::vector<Timer> m_Overflow; // Beyond the top level range
+		std::mutex m_Mutex;
+	};
+}
@@ -1,5 +1,7 @@
 #include "WorkerThread.h"
 #include "JobSystem.h"
+#include "TaskGroup.h"
+#include "SpinPolicy.h"
 #include <chrono>
 #include <thread>
 
@@ -8,70 +10,161 @@ namespace SV
 
 	void WorkerThread::Run()
 	{
-		// Wait for all workers to be reaady
-		JobSystem::Get().WorkerThreadReady();
-
-		constexpr uint32_t MAX_IDLE_SPINS = 256;
+		// Bounds a missed wakeup of the timer keeper between computing its deadline and sleeping
+		constexpr std::chrono::milliseconds MAX_KEEPER_SLEEP(10);
+		AdaptiveSpinBudget& idleSpinBudget = SpinPolicy::GetIdleBudget();
 		uint32_t idleSpinCount = 0;
+		uint32_t maxIdleSpins = 0;
+		bool bSearching = false;
+		bool bIdleOutcomePending = false; // The current idle phase is not reported to the spin budget yet
+		std::chrono::steady_clock::time_point idleStartTime;
+		const bool bTimerKeeper = m_JobSystem->IsTimerKeeper(m_WorkerId);
+		s_Current = this;
 
 		while (!IsStopRequested())
 		{
+			if (IsParked() && m_TaskQueue.IsEmpty() && m_Mailbox.IsEmpty())
+			{
+				// Parked workers cost no CPU until unparked, the timer keeper still wakes for due timers
+				std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+				if (bTimerKeeper)
+				{
+					m_JobSystem->ServiceTimers();
+					deadline = m_JobSystem->GetTimerWheel().IsEmpty()
+						? std::chrono::steady_clock::now() + MAX_KEEPER_SLEEP
+						: m_JobSystem->GetTimerWheel().GetNextTickTime();
+				}
+				Platform::WaitOnAddress(m_ParkState, WORKER_PARKED, deadline);
+				continue;
+			}
+
 			std::shared_ptr<JobTask> task = AcquireTask();
 
 			if (task)
 			{
+				if (bSearching)
+				{
+					m_JobSystem->SetWorkerSearching(*this, false);
+					bSearching = false;
+					if (bIdleOutcomePending)
+					{
+						idleSpinBudget.RecordOutcome(idleSpinCount, true);
+						bIdleOutcomePending = false;
+					}
+				}
 				ExecuteTask(std::move(task));
 				idleSpinCount = 0;
 			}
 			else 
 			{
-				if (++idleSpinCount < MAX_IDLE_SPINS)
+				m_JobSystem->ServiceTimers();
+
+				if (!bSearching)
 				{
-					#if defined(_MSC_VER)
-						_mm_pause();
-					#else
-						__builtin_ia32_pause();
-					#endif
+					m_JobSystem->SetWorkerSearching(*this, true);
+					bSearching = true;
+					bIdleOutcomePending = true;
+					idleStartTime = std::chrono::steady_clock::now();
+					maxIdleSpins = idleSpinBudget.Get();
 				}
-				else //if (idleSpinCount < MAX_IDLE_SPINS * 2)
+
+				if (++idleSpinCount < maxIdleSpins)
+				{
+					Platform::CpuPause();
+					continue;
+				}
+
+				// Spinning is over. Workers that can't park yet keep yielding, work they find past the late window is
+				// no reason for a longer budget
+				if (bIdleOutcomePending && idleSpinCount > maxIdleSpins + maxIdleSpins / 4)
+				{
+					idleSpinBudget.RecordOutcome(idleSpinCount, false);
+					bIdleOutcomePending = false;
+				}
+				if (m_JobSystem->TryParkWorker(*this, std::chrono::steady_clock::now() - idleStartTime))
+				{
+					// Steals kept failing for the idle park time, or the group is above its active count
+					if (bIdleOutcomePending)
+					{
+						idleSpinBudget.RecordOutcome(idleSpinCount, false);
+						bIdleOutcomePending = false;
+					}
+					bSearching = false;
+					idleSpinCount = 0;
+				}
+				else
 				{
 					// Yield to OS
 					std::this_thread::yield();
 				}
-// 				else
-// 				{
-// 					// Sleep
-// 					//std::shared_ptr<JobTask> waitTask = m_JobSystem->WaitForTask(m_StopRequested);
-// 
-// 					if (waitTask)
-// 					{
-// 						ExecuteTask(waitTask);
-// 						idleSpinCount = 0;
-// 					}
-// 				}
 			}
 		}
 
+		if (bSearching)
+		{
+			m_JobSystem->SetWorkerSearching(*this, false);
+		}
 		m_TaskQueue.Clear();
+		m_Mailbox.Clear();
+		s_Current = nullptr;
+	}
+
+	bool WorkerThread::TryExecuteTask()
+	{
+		std::shared_ptr<JobTask> task = AcquireTask();
+		if (!task)
+		{
+			return false;
+		}
+		ExecuteTask(std::move(task));
+		return true;
+	}
+
+	bool WorkerThread::TryExecuteSpawnedTask(const TaskGroup& group)
+	{
+		std::shared_ptr<JobTask> task = m_TaskQueue.PopIf([&group](const JobTask& queuedTask) { return queuedTask.GetTaskGroup() == &group; });
+		if (!task)
+		{
+			return false;
+		}
+		ExecuteTask(std::move(task));
+		return true;
 	}
 
 	std::shared_ptr<JobTask> WorkerThread::AcquireTask()
 	{
-		// 1. Try local queue first (best cahche locality)
-		std::shared_ptr<JobTask> task = m_TaskQueue.Pop();
+		std::shared_ptr<JobTask> task;
+
+		// 0. Earliest deadline first while any deadline task is queued, even over local work
+		if (m_JobSystem->HasQueuedDeadlineTasks())
+		{
+			task = m_JobSystem->PopEarliestDeadlineTask(m_WorkerId);
+			if (task)
+			{
+				return task;
+			}
+		}
+
+		// 1. Tasks targeted at this worker, then the local queue (best cahche locality)
+		task = m_Mailbox.Pop();
+		if (task)
+		{
+			return task;
+		}
+		task = m_TaskQueue.Pop();
 		if (task)
 		{
 			return task;
 		}
 
 		// 2. Try global queue
-		task = m_JobSystem->PopGlobalQueue();
+		task = m_JobSystem->PopGlobalQueue(m_Group);
 		if (task)
 		{
 			return task;
 		}
 
-		// 3. Try stealing from other workers
+		// 3. Try stealing from other workers, other groups if allowed
 		task = m_JobSystem->StealTaskFor(m_WorkerId);
 		if (task)
 		{
@@ -82,24 +175,82 @@ namespace SV
 
 	void WorkerThread::ExecuteTask(std::shared_ptr<JobTask> task)
 	{
-		// TODO: integrate profiling
-		std::chrono::high_resolution_clock::time_point t1, t2;
-		if constexpr (false) // use option to enable logging
-		{
-			t1 = std::chrono::high_resolution_clock::now();
-		}
-		task->DoTask();
-		if constexpr (false)
+		// Bounds a long chain of continuations so queued work isn't starved
+		constexpr int32_t MAX_INLINE_CONTINUATIONS = 32;
+
+		bool bInlined = false;
+		for (int32_t inlineDepth = 0; task; ++inlineDepth)
 		{
-			t2 = std::chrono::high_resolution_clock::now();
-			// log data here
+			// Shutdown cancels whatever is still queued, the event is completed as abandoned
+			const bool bCancelled = m_JobSystem->IsCancellingTasks() && !task->HasFlags(ETaskFlags::NotCancellable);
+
+			// TODO: integrate profiling
+			std::chrono::high_resolution_clock::time_point t1, t2;
+			if constexpr (false) // use option to enable logging
+			{
+				t1 = std::chrono::high_resolution_clock::now();
+			}
+			const bool bTimed = !bCancelled && m_JobSystem->IsTaskTimed(*task);
+			const std::chrono::steady_clock::time_point startTime = bTimed ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+			if (!bCancelled && task->HasFlags(ETaskFlags::Blocking))
+			{
+				ScopedBlockingRegion blockingRegion;
+				task->DoTask();
+			}
+			else if (!bCancelled)
+			{
+				task->DoTask();
+			}
+			if constexpr (false)
+			{
+				t2 = std::chrono::high_resolution_clock::now();
+				// log data here
+			}
+			if (bTimed)
+			{
+				m_JobSystem->RecordTaskExecution(*task, m_WorkerId, startTime, std::chrono::steady_clock::now());
+			}
+			if (task->HasDeadline())
+			{
+				m_JobSystem->RecordDeadlineTaskCompleted(*task, std::chrono::steady_clock::now(), !bInlined);
+			}
+			if (TaskGroup* taskGroup = task->GetTaskGroup())
+			{
+				taskGroup->OnBranchDone();
+			}
+
+			// Notify completion, one ready subsequent may continue on this worker without a queue round trip
+			std::shared_ptr<JobTask> continuation;
+			if (auto event = task->GetEvent())
+			{
+				if (bCancelled)
+				{
+					event->Abandon();
+				}
+				else
+				{
+					event->Complete(inlineDepth < MAX_INLINE_CONTINUATIONS ? &continuation : nullptr);
+				}
+			}
+			if (continuation && !CanInlineContinuation(*continuation))
+			{
+				continuation->GetScheduler().DispatchTask(std::move(continuation));
+			}
+			task = std::move(continuation);
+			bInlined = true;
 		}
-		// Notify completion
-		if (auto event = task->GetEvent())
+		// Retired after the whole chain, subsequents dispatched on the way are already counted
+		m_JobSystem->OnTaskRetired();
+	}
+
+	bool WorkerThread::CanInlineContinuation(const JobTask& task) const
+	{
+		// Other groups and schedulers keep their own workers, queued deadline tasks take precedence in EDF order
+		if (&task.GetScheduler() != m_JobSystem || task.GetGroup() != m_Group || m_JobSystem->HasQueuedDeadlineTasks())
 		{
-			event->Complete();
+			return false;
 		}
+		return !task.HasAffinity() || m_JobSystem->ResolveAffinityWorker(task) == m_WorkerId;
 	}
 
-}
-
+}
\ No newline at end of file
@@ -1,21 +1,28 @@
 #pragma once
 #include "Threading/ThreadTypes.h"
 #include "TaskQueues.h"
+#include "TaskMemory.h"
+#include "Platform/Platform.h"
 #include <atomic>
 #include <memory>
 
 namespace SV
 {
 	class JobSystem;
+	class TaskGroup;
 
 	class WorkerThread : public IThreadRunnable
 	{
 	public:
-		WorkerThread(int32_t workerId, JobSystem* jobSystem)
+		WorkerThread(int32_t workerId, EWorkerGroup group, JobSystem* jobSystem, bool bSpare = false)
 			: m_WorkerId(workerId)
+			, m_Group(group)
 			, m_JobSystem(jobSystem)
 			, m_StopRequested(false)
 			, m_HasWork(false)
+			, m_bSpare(bSpare)
+			, m_ParkState(bSpare ? WORKER_PARKED : WORKER_ACTIVE)
+			, m_TaskMemory(jobSystem)
 		{}
 
 		void Run() override;
@@ -23,6 +30,8 @@ namespace SV
 		void RequestStop() override
 		{
 			m_StopRequested.store(true, std::memory_order_release);
+			m_ParkState.store(WORKER_STOPPING, std::memory_order_release);
+			Platform::WakeAllOnAddress(m_ParkState);
 		}
 
 		bool IsStopRequested() const override
@@ -32,21 +41,91 @@ namespace SV
 
 		std::string GetThreadName() const override 
 		{ 
-			return "Worker_" + std::to_string(m_WorkerId);
+			if (m_bSpare)
+			{
+				return "SpareWorker_" + std::to_string(m_WorkerId);
+			}
+			switch (m_Group)
+			{
+			case EWorkerGroup::Background: return "BackgroundWorker_" + std::to_string(m_WorkerId);
+			case EWorkerGroup::BlockingIO: return "IOWorker_" + std::to_string(m_WorkerId);
+			default: return "Worker_" + std::to_string(m_WorkerId);
+			}
 		}
 
 		ITaskQueue* GetLocalQueue() override { return &m_TaskQueue; }
+		TaskMailbox& GetMailbox() { return m_Mailbox; }
+
+		// Core the worker is pinned to, -1 if it may float
+		int32_t GetPinnedCore() const { return m_PinnedCore; }
+		void SetPinnedCore(int32_t core) { m_PinnedCore = core; }
+		void SetQueueCapacity(size_t capacity) { m_TaskQueue.SetCapacity(capacity); }
 
 		int32_t GetId() const { return m_WorkerId; }
+		EWorkerGroup GetGroup() const { return m_Group; }
+		JobSystem* GetJobSystem() const { return m_JobSystem; }
+		// Scratch and frame allocators, see TaskMemory
+		TaskMemory& GetTaskMemory() { return m_TaskMemory; }
+		const TaskMemory& GetTaskMemory() const { return m_TaskMemory; }
+
+		// Worker running on the calling thread, of any job system instance
+		static WorkerThread* GetCurrent() { return s_Current; }
+
+		// Executes one queued task on the calling worker, used while waiting inside a task
+		bool TryExecuteTask();
+		// Runs a task the caller already holds, e.g. one a full queue didn't take
+		void ExecuteTask(std::shared_ptr<JobTask> task);
+		// Executes the newest local task if the group spawned it, i.e. no other worker stole it
+		bool TryExecuteSpawnedTask(const TaskGroup& group);
+
+		// Spare workers start parked and are woken while a worker of their group is in a blocking region,
+		// regular workers are parked and woken by the group scaling
+		bool IsSpare() const { return m_bSpare; }
+		bool IsParked() const { return m_ParkState.load(std::memory_order_acquire) == WORKER_PARKED; }
+		bool TryUnpark()
+		{
+			uint32_t expected = WORKER_PARKED;
+			if (!m_ParkState.compare_exchange_strong(expected, WORKER_ACTIVE, std::memory_order_seq_cst))
+			{
+				return false;
+			}
+			Platform::WakeAllOnAddress(m_ParkState);
+			return true;
+		}
+		// Sleeps once the local queue is drained
+		bool TryPark()
+		{
+			uint32_t expected = WORKER_ACTIVE;
+			return m_ParkState.compare_exchange_strong(expected, WORKER_PARKED, std::memory_order_seq_cst);
+		}
+		// Wakes a parked worker without unparking it, so it can re-evaluate its wait deadline
+		void Poke() { Platform::WakeAllOnAddress(m_ParkState); }
+
+		// Nested regions count once, returns true for the outermost one
+		bool EnterBlockingRegion() { return m_BlockingDepth++ == 0; }
+		bool LeaveBlockingRegion() { return --m_BlockingDepth == 0; }
 
 	private:
 		std::shared_ptr<JobTask> AcquireTask();
-		void ExecuteTask(std::shared_ptr<JobTask> task);
+		bool CanInlineContinuation(const JobTask& task) const;
 	private:
 		int32_t m_WorkerId;
+		EWorkerGroup m_Group;
 		JobSystem* m_JobSystem;
 		std::atomic<bool> m_StopRequested;
 		std::atomic<bool> m_HasWork;
 		TaskLocalQueue m_TaskQueue;
+		TaskMailbox m_Mailbox;
+		int32_t m_PinnedCore = -1;
+
+		static constexpr uint32_t WORKER_PARKED = 0;
+		static constexpr uint32_t WORKER_ACTIVE = 1;
+		static constexpr uint32_t WORKER_STOPPING = 2;
+		const bool m_bSpare;
+		std::atomic<uint32_t> m_ParkState;
+		int32_t m_BlockingDepth = 0; // Only touched by the owning thread
+		TaskMemory m_TaskMemory;
+
+		static inline thread_local WorkerThread* s_Current = nullptr;
 	};
 }
\ No newline at end of file
@@ -1,9 +1,30 @@
 #pragma once
+#include "Threading/ThreadTypes.h"
 #include <thread>
 #include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <vector>
 
 #ifdef _WIN32
 #include <windows.h>
+#pragma comment(lib, "Synchronization.lib")
+#elif defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <ctime>
+#include <cerrno>
+#include <sched.h>
+#include <sys/resource.h>
+#endif
+
+#if defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#elif defined(_M_ARM64) || defined(_M_ARM)
+#include <intrin.h>
 #endif
 
 namespace SV
@@ -17,6 +38,66 @@ namespace SV
 			return count > 0 ? count : 1;
 		}
 
+		enum class ECacheLevel : uint8_t
+		{
+			LineSize, // Bytes per cache line
+			L1Data,
+			L2
+		};
+
+		// Falls back to common x86 values when the OS doesn't report the cache, e.g. in some containers
+		static size_t GetCacheSize(ECacheLevel level)
+		{
+			size_t size = 0;
+#ifdef _WIN32
+			DWORD bufferSize = 0;
+			GetLogicalProcessorInformation(nullptr, &bufferSize);
+			std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> infos(bufferSize / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+			if (!infos.empty() && GetLogicalProcessorInformation(infos.data(), &bufferSize))
+			{
+				for (const SYSTEM_LOGICAL_PROCESSOR_INFORMATION& info : infos)
+				{
+					if (info.Relationship != RelationCache)
+					{
+						continue;
+					}
+					const CACHE_DESCRIPTOR& cache = info.Cache;
+					if (level == ECacheLevel::LineSize && cache.Level == 1)
+					{
+						size = cache.LineSize;
+					}
+					else if (level == ECacheLevel::L1Data && cache.Level == 1 && cache.Type != CacheInstruction)
+					{
+						size = cache.Size;
+					}
+					else if (level == ECacheLevel::L2 && cache.Level == 2)
+					{
+						size = cache.Size;
+					}
+				}
+			}
+#elif defined(__linux__) && defined(_SC_LEVEL1_DCACHE_LINESIZE)
+			long value = 0;
+			switch (level)
+			{
+			case ECacheLevel::LineSize: value = sysconf(_SC_LEVEL1_DCACHE_LINESIZE); break;
+			case ECacheLevel::L1Data: value = sysconf(_SC_LEVEL1_DCACHE_SIZE); break;
+			case ECacheLevel::L2: value = sysconf(_SC_LEVEL2_CACHE_SIZE); break;
+			}
+			size = value > 0 ? static_cast<size_t>(value) : 0;
+#endif
+			if (size == 0)
+			{
+				switch (level)
+				{
+				case ECacheLevel::LineSize: size = 64; break;
+				case ECacheLevel::L1Data: size = 32 * 1024; break;
+				case ECacheLevel::L2: size = 256 * 1024; break;
+				}
+			}
+			return size;
+		}
+
 		static void SetThreadAffinity(std::thread& thread, uint64_t affinityMask)
 		{
 #ifdef _WIN32
@@ -39,6 +120,127 @@ namespace SV
 #endif
 		}
 
+		// Applies to the calling thread. Raising priority may require privileges, failures are ignored
+		static void SetCurrentThreadPriority(EThreadPriority priority)
+		{
+#ifdef _WIN32
+			int winPriority = THREAD_PRIORITY_NORMAL;
+			switch (priority)
+			{
+			case EThreadPriority::Low: winPriority = THREAD_PRIORITY_BELOW_NORMAL; break;
+			case EThreadPriority::Normal: winPriority = THREAD_PRIORITY_NORMAL; break;
+			case EThreadPriority::High: winPriority = THREAD_PRIORITY_ABOVE_NORMAL; break;
+			case EThreadPriority::Critical: winPriority = THREAD_PRIORITY_TIME_CRITICAL; break;
+			}
+			SetThreadPriority(GetCurrentThread(), winPriority);
+#elif defined(__linux__)
+			if (priority == EThreadPriority::Critical)
+			{
+				sched_param param{};
+				param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+				if (sched_setscheduler(0, SCHED_FIFO, &param) == 0)
+				{
+					return;
+				}
+				// Needs CAP_SYS_NICE, fall back to the lowest nice value we are allowed
+			}
+
+			int niceValue = 0;
+			switch (priority)
+			{
+			case EThreadPriority::Low: niceValue = 5; break;
+			case EThreadPriority::Normal: niceValue = 0; break;
+			case EThreadPriority::High: niceValue = -5; break;
+			case EThreadPriority::Critical: niceValue = -10; break;
+			}
+			// Nice values are per thread on Linux
+			setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), niceValue);
+#else
+			(void)priority;
+#endif
+		}
+
+		// Blocks while word == expected. Returns false if the deadline passed, spurious wakeups return true
+		static bool WaitOnAddress(std::atomic<uint32_t>& word, uint32_t expected, std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max())
+		{
+			const bool bInfinite = deadline == std::chrono::steady_clock::time_point::max();
+#ifdef _WIN32
+			DWORD timeoutMs = INFINITE;
+			if (!bInfinite)
+			{
+				auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+				if (remaining.count() <= 0)
+				{
+					return false;
+				}
+				timeoutMs = static_cast<DWORD>(remaining.count());
+			}
+			::WaitOnAddress(&word, &expected, sizeof(uint32_t), timeoutMs);
+			return bInfinite || std::chrono::steady_clock::now() < deadline;
+#elif defined(__linux__)
+			// steady_clock is CLOCK_MONOTONIC, so the deadline can be passed as an absolute timeout
+			timespec absTimeout{};
+			if (!bInfinite)
+			{
+				auto sinceEpoch = deadline.time_since_epoch();
+				auto seconds = std::chrono::duration_cast<std::chrono::seconds>(sinceEpoch);
+				absTimeout.tv_sec = static_cast<time_t>(seconds.count());
+				absTimeout.tv_nsec = static_cast<long>(std::chrono::duration_cast<std::chrono::nanoseconds>(sinceEpoch - seconds).count());
+			}
+			long result = syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_BITSET_PRIVATE, expected,
+				bInfinite ? nullptr : &absTimeout, nullptr, FUTEX_BITSET_MATCH_ANY);
+			return !(result == -1 && errno == ETIMEDOUT);
+#else
+			if (bInfinite)
+			{
+				word.wait(expected, std::memory_order_acquire);
+				return true;
+			}
+			std::this_thread::sleep_for(std::chrono::microseconds(50));
+			return std::chrono::steady_clock::now() < deadline;
+#endif
+		}
+
+		static void WakeAllOnAddress(std::atomic<uint32_t>& word)
+		{
+#ifdef _WIN32
+			::WakeByAddressAll(&word);
+#elif defined(__linux__)
+			syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, INT32_MAX, nullptr, nullptr, 0);
+#else
+			word.notify_all();
+#endif
+		}
+
+		static void WakeOneOnAddress(std::atomic<uint32_t>& word)
+		{
+#ifdef _WIN32
+			::WakeByAddressSingle(&word);
+#elif defined(__linux__)
+			syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#else
+			word.notify_one();
+#endif
+		}
+
+		// Spin-wait hint, lets the sibling hyperthread run and saves power while polling
+		static inline void CpuPause()
+		{
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+			_mm_pause();
+#elif defined(_M_ARM64) || defined(_M_ARM)
+			__yield();
+#elif defined(__aarch64__) || defined(__arm__)
+			__asm__ __volatile__("yield");
+#endif
+		}
+
+		// Gives up the rest of the timeslice, for waiters that should let a descheduled owner run
+		static void YieldThread()
+		{
+			std::this_thread::yield();
+		}
+
 		static bool RequiresRenderThread()
 		{
 			return true;
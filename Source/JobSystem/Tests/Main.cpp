@@ -0,0 +1,43 @@
+// Tests, run all or the ones named on the command line. Exits non-zero if any failed
+
+#include "Tests.h"
+
+#include <cstring>
+#include <iostream>
+
+using namespace SV::Tests;
+
+struct TestEntry
+{
+	const char* Name;
+	bool (*Function)();
+};
+
+static const TestEntry s_Tests[] =
+{
+	{ "TaskGraphBinaryMinimalNodes", Test_TaskGraphBinaryMinimalNodes },
+	{ "TaskGraphCorruptTextPrerequisites", Test_TaskGraphCorruptTextPrerequisites },
+	{ "TaskGraphLaterPrerequisites", Test_TaskGraphLaterPrerequisites },
+};
+
+int main(int argc, char** argv)
+{
+	int32_t failedCount = 0;
+	for (const TestEntry& test : s_Tests)
+	{
+		bool bSelected = argc < 2;
+		for (int i = 1; i < argc; ++i)
+		{
+			bSelected |= std::strcmp(argv[i], test.Name) == 0;
+		}
+		if (!bSelected)
+		{
+			continue;
+		}
+
+		const bool bPassed = test.Function();
+		std::cout << (bPassed ? "[PASS] " : "[FAIL] ") << test.Name << "\n";
+		failedCount += bPassed ? 0 : 1;
+	}
+	return failedCount == 0 ? 0 : 1;
+}
@@ -0,0 +1,100 @@
+// Task graph and workload file loading
+
+#include "Tests.h"
+#include "Jobs/TaskGraph.h"
+
+#include <fstream>
+
+namespace SV::Tests
+{
+	bool Test_TaskGraphBinaryMinimalNodes()
+	{
+		// Tasks that never ran with small ids and no prerequisites take one byte per field
+		TaskGraph graph;
+		for (uint64_t id = 1; id <= 100; ++id)
+		{
+			TaskGraphNode node;
+			node.Id = id;
+			graph.Nodes.push_back(node);
+		}
+
+		const std::string path = GetTempPath("JobSystemTestMinimal.bin");
+		bool bPassed = Check(graph.SaveBinary(path), "SaveBinary succeeds");
+		TaskGraph loaded;
+		bPassed &= Check(TaskGraph::Load(path, loaded), "Load accepts the file SaveBinary wrote");
+		bPassed &= Check(loaded.Nodes.size() == graph.Nodes.size(), "Every node is loaded");
+		std::filesystem::remove(path);
+		return bPassed;
+	}
+
+	bool Test_TaskGraphCorruptTextPrerequisites()
+	{
+		const std::string path = GetTempPath("JobSystemTestCorrupt.tsv");
+		bool bPassed = true;
+		for (const char* prerequisites : { "x", "1,x", "1x", ",", "99999999999999999999999" })
+		{
+			{
+				std::ofstream file(path);
+				file << "# id\tworker\tready_ns\tstart_ns\tend_ns\tprerequisites\tlabel\n";
+				file << "1\t0\t10\t20\t30\t-\tInput\n";
+				file << "2\t0\t30\t40\t50\t" << prerequisites << "\tRender\n";
+			}
+			TaskGraph loaded;
+			bPassed &= Check(!TaskGraph::Load(path, loaded), "Load rejects a malformed prerequisite list");
+		}
+		std::filesystem::remove(path);
+		return bPassed;
+	}
+
+	bool Test_TaskGraphLaterPrerequisites()
+	{
+		// A node depending on itself or on a later node can never become ready
+		bool bPassed = true;
+		const std::string textPath = GetTempPath("JobSystemTestLater.tsv");
+		for (const char* prerequisites : { "2", "3", "1,2" })
+		{
+			{
+				std::ofstream file(textPath);
+				file << "# id\tworker\tready_ns\tstart_ns\tend_ns\tprerequisites\tlabel\n";
+				file << "1\t0\t10\t20\t30\t-\tInput\n";
+				file << "2\t0\t30\t40\t50\t" << prerequisites << "\tRender\n";
+				file << "3\t0\t50\t60\t70\t-\tPresent\n";
+			}
+			TaskGraph loaded;
+			bPassed &= Check(!TaskGraph::Load(textPath, loaded), "Text Load rejects a prerequisite that is not an earlier node");
+		}
+		std::filesystem::remove(textPath);
+
+		const std::string binaryPath = GetTempPath("JobSystemTestLater.bin");
+		for (uint64_t prerequisiteId : { 2, 3 })
+		{
+			TaskGraph graph;
+			for (uint64_t id = 1; id <= 3; ++id)
+			{
+				TaskGraphNode node;
+				node.Id = id;
+				graph.Nodes.push_back(node);
+			}
+			graph.Nodes[1].Prerequisites.push_back(prerequisiteId);
+			TaskGraph loaded;
+			bPassed &= Check(graph.SaveBinary(binaryPath), "SaveBinary succeeds");
+			bPassed &= Check(!TaskGraph::Load(binaryPath, loaded), "Binary Load rejects a prerequisite that is not an earlier node");
+		}
+		std::filesystem::remove(binaryPath);
+
+		// The earlier node is still accepted
+		TaskGraph graph;
+		for (uint64_t id = 1; id <= 3; ++id)
+		{
+			TaskGraphNode node;
+			node.Id = id;
+			graph.Nodes.push_back(node);
+		}
+		graph.Nodes[1].Prerequisites.push_back(1);
+		TaskGraph loaded;
+		bPassed &= Check(graph.SaveBinary(binaryPath) && TaskGraph::Load(binaryPath, loaded), "Binary Load accepts an earlier prerequisite");
+		bPassed &= Check(loaded.Nodes.size() == 3 && loaded.Nodes[1].Prerequisites == std::vector<uint64_t>{ 1 }, "The prerequisite round trips");
+		std::filesystem::remove(binaryPath);
+		return bPassed;
+	}
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+namespace SV::Tests
+{
+	// Each test returns false if any of its checks failed
+	bool Test_TaskGraphBinaryMinimalNodes();
+	bool Test_TaskGraphCorruptTextPrerequisites();
+	bool Test_TaskGraphLaterPrerequisites();
+
+	// Prints the failed condition, the test keeps going to report the rest
+	inline bool Check(bool bCondition, const char* description)
+	{
+		if (!bCondition)
+		{
+			std::cout << "  FAILED: " << description << "\n";
+		}
+		return bCondition;
+	}
+
+	inline std::string GetTempPath(const char* fileName)
+	{
+		return (std::filesystem::temp_directory_path() / fileName).string();
+	}
+}
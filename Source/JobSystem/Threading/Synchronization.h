@@ -1,5 +1,14 @@
 #pragma once
+#include "Platform/Platform.h"
+
+#include <algorithm>
 #include <atomic>
+#include <cstdint>
+
+// Per-lock and process wide acquire/contention/sleep counters, off by default since they add atomics to every acquire
+#ifndef SV_LOCK_CONTENTION_STATS
+#define SV_LOCK_CONTENTION_STATS 0
+#endif
 
 namespace SV
 {
@@ -8,16 +17,17 @@ namespace SV
 	public:
 		void Lock()
 		{
-			while (m_Flag.test_and_set(std::memory_order_acquire)) 
+			uint32_t pauseCount = 1;
+			while (m_Flag.test_and_set(std::memory_order_acquire))
 			{
-				// Yield to reduce contention
+				// Spin on a plain load with exponential backoff so waiters don't keep stealing the line from the owner
 				while (m_Flag.test(std::memory_order_relaxed))
 				{
-					#if defined(_MSC_VER)
-						_mm_pause(); // x86/x64 instruction
-					#else
-						__builtin_ia32_pause(); // GCC/Clang
-					#endif
+					for (uint32_t i = 0; i < pauseCount; ++i)
+					{
+						Platform::CpuPause();
+					}
+					pauseCount = std::min(pauseCount * 2, MAX_PAUSE_COUNT);
 				}
 			}
 		}
@@ -32,6 +42,8 @@ namespace SV
 			return !m_Flag.test_and_set(std::memory_order_acquire);
 		}
 	private:
+		static constexpr uint32_t MAX_PAUSE_COUNT = 64;
+
 		std::atomic_flag m_Flag = ATOMIC_FLAG_INIT;
 	};
 
@@ -51,4 +63,157 @@ namespace SV
 	private:
 		SpinLock& m_Lock;
 	};
-}
\ No newline at end of file
+
+	struct LockContentionStats
+	{
+		uint64_t Acquires = 0;
+		// Acquires that found the lock taken and had to spin or sleep
+		uint64_t ContendedAcquires = 0;
+		// Times a waiter went to sleep in the kernel
+		uint64_t Sleeps = 0;
+	};
+
+	struct LockContentionCounters
+	{
+		std::atomic<uint64_t> Acquires{ 0 };
+		std::atomic<uint64_t> ContendedAcquires{ 0 };
+		std::atomic<uint64_t> Sleeps{ 0 };
+
+		LockContentionStats Get() const
+		{
+			return { Acquires.load(std::memory_order_relaxed), ContendedAcquires.load(std::memory_order_relaxed), Sleeps.load(std::memory_order_relaxed) };
+		}
+	};
+
+	// Spins with exponential backoff while the owner is likely still running, then sleeps on the lock word.
+	// A descheduled owner costs waiters a futex wait instead of their whole timeslice. Unlock only enters the kernel
+	// when somebody is asleep. Meant for short critical sections such as the task queues and event lists.
+	class AdaptiveLock
+	{
+	public:
+		void Lock()
+		{
+			uint32_t expected = UNLOCKED;
+			if (!m_State.compare_exchange_strong(expected, LOCKED, std::memory_order_acquire, std::memory_order_relaxed))
+			{
+				LockContended();
+			}
+			CountStat(&LockContentionCounters::Acquires);
+		}
+
+		bool TryLock()
+		{
+			uint32_t expected = UNLOCKED;
+			if (m_State.compare_exchange_strong(expected, LOCKED, std::memory_order_acquire, std::memory_order_relaxed))
+			{
+				CountStat(&LockContentionCounters::Acquires);
+				return true;
+			}
+			return false;
+		}
+
+		void Unlock()
+		{
+			if (m_State.exchange(UNLOCKED, std::memory_order_release) == SLEEPERS)
+			{
+				Platform::WakeOneOnAddress(m_State);
+			}
+		}
+
+		// Zeros unless built with SV_LOCK_CONTENTION_STATS
+		LockContentionStats GetStats() const
+		{
+#if SV_LOCK_CONTENTION_STATS
+			return m_Stats.Get();
+#else
+			return {};
+#endif
+		}
+
+		// Summed over every AdaptiveLock in the process
+		static LockContentionStats GetGlobalStats()
+		{
+#if SV_LOCK_CONTENTION_STATS
+			return s_GlobalStats.Get();
+#else
+			return {};
+#endif
+		}
+
+	private:
+		static constexpr uint32_t UNLOCKED = 0;
+		static constexpr uint32_t LOCKED = 1;
+		// Locked and at least one waiter may be sleeping on m_State
+		static constexpr uint32_t SLEEPERS = 2;
+
+		static constexpr int32_t MAX_SPIN_ROUNDS = 10;
+		static constexpr uint32_t MAX_PAUSE_COUNT = 64;
+
+		void CountStat([[maybe_unused]] std::atomic<uint64_t> LockContentionCounters::* counter)
+		{
+#if SV_LOCK_CONTENTION_STATS
+			(m_Stats.*counter).fetch_add(1, std::memory_order_relaxed);
+			(s_GlobalStats.*counter).fetch_add(1, std::memory_order_relaxed);
+#endif
+		}
+
+		void LockContended()
+		{
+			CountStat(&LockContentionCounters::ContendedAcquires);
+
+			// Spinning can't help while the owner waits for our core
+			static const int32_t s_SpinRounds = Platform::GetLogicalCoreCount() > 1 ? MAX_SPIN_ROUNDS : 0;
+			uint32_t pauseCount = 1;
+			for (int32_t round = 0; round < s_SpinRounds; ++round)
+			{
+				for (uint32_t i = 0; i < pauseCount; ++i)
+				{
+					Platform::CpuPause();
+				}
+				pauseCount = std::min(pauseCount * 2, MAX_PAUSE_COUNT);
+
+				uint32_t state = m_State.load(std::memory_order_relaxed);
+				if (state == UNLOCKED && m_State.compare_exchange_weak(state, LOCKED, std::memory_order_acquire, std::memory_order_relaxed))
+				{
+					return;
+				}
+				if (state == SLEEPERS)
+				{
+					// Others already gave up spinning, queue behind them
+					break;
+				}
+			}
+
+			// Taking the lock as SLEEPERS is conservative, the next Unlock may wake a thread that finds nothing to do
+			while (m_State.exchange(SLEEPERS, std::memory_order_acquire) != UNLOCKED)
+			{
+				CountStat(&LockContentionCounters::Sleeps);
+				Platform::WaitOnAddress(m_State, SLEEPERS);
+			}
+		}
+
+	private:
+		std::atomic<uint32_t> m_State{ UNLOCKED };
+#if SV_LOCK_CONTENTION_STATS
+		LockContentionCounters m_Stats;
+		static inline LockContentionCounters s_GlobalStats;
+#endif
+	};
+
+	class ScopedAdaptiveLock
+	{
+	public:
+		explicit ScopedAdaptiveLock(AdaptiveLock& lock) : m_Lock(lock)
+		{
+			m_Lock.Lock();
+		}
+		~ScopedAdaptiveLock()
+		{
+			m_Lock.Unlock();
+		}
+		ScopedAdaptiveLock(const ScopedAdaptiveLock&) = delete;
+		ScopedAdaptiveLock& operator=(const ScopedAdaptiveLock&) = delete;
+	private:
+		AdaptiveLock& m_Lock;
+	};
+}
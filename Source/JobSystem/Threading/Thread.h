@@ -1,10 +1,10 @@
 #pragma  once
 #include "Threading/ThreadTypes.h"
+#include "Platform/Platform.h"
 #include <thread>
 #include <memory>
 #include <string>
-#include <iostream>
-#include <mutex>
+#include <atomic>
 
 namespace SV
 {
@@ -27,7 +27,6 @@ namespace SV
 			{
 				m_Runnable->RequestStop();
 				m_Thread.join();
-				std::cout << "[Thread] '" << m_Name << "' destroyed\n";
 			}
 		}
 
@@ -46,11 +45,8 @@ namespace SV
 
 		void Launch()
 		{
-			{
-				std::unique_lock<std::mutex> lock(m_Mutex);
-				m_bReady = true;
-			}
-			m_Cv.notify_one();
+			m_LaunchState.store(1, std::memory_order_release);
+			Platform::WakeAllOnAddress(m_LaunchState);
 		}
 
 		void RequestStop()
@@ -76,15 +72,17 @@ namespace SV
 		{
 			m_Thread = std::thread(&Thread::Execute, this);
 			m_ThreadId = m_Thread.get_id();
-			std::cout << "[Thread] '" << m_Name << "' started with ID: " << m_ThreadId << "\n";
 		}
 
 
 		void Execute()
 		{
-			std::unique_lock<std::mutex> lock(m_Mutex);
-			m_Cv.wait(lock, [this]{return m_bReady; });
-			// Set thread priority here
+			// Futex wait instead of a mutex handshake, a launched thread never enters the kernel here
+			while (m_LaunchState.load(std::memory_order_acquire) == 0)
+			{
+				Platform::WaitOnAddress(m_LaunchState, 0);
+			}
+			Platform::SetCurrentThreadPriority(m_Priority);
 			m_Runnable->Run();
 		}
 
@@ -95,8 +93,6 @@ namespace SV
 		std::thread m_Thread;
 		std::thread::id m_ThreadId;
 		EThreadPriority m_Priority;
-		std::mutex m_Mutex;
-		std::condition_variable m_Cv;
-		bool m_bReady = false;
+		std::atomic<uint32_t> m_LaunchState{ 0 };
 	};
 }
\ No newline at end of file
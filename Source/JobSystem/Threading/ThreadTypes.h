@@ -1,5 +1,6 @@
 #pragma once
 #include <atomic>
+#include <chrono>
 #include <memory>
 #include <string>
 
@@ -23,17 +24,55 @@ namespace SV
 		AudioThread
 	};
 
+	enum class EWorkerGroup : uint8_t
+	{
+		Foreground, // Frame critical work
+		Background, // Long running jobs, e.g. shader compiles and asset cooking
+		BlockingIO, // Tasks that block in the kernel
+		Count
+	};
+
+	// What a producer does when the queue it dispatches to is at capacity
+	enum class EBackpressurePolicy : uint8_t
+	{
+		RunInline, // Runs the task on the producer, tasks that can't run inline fall back to HelpDrain
+		HelpDrain, // Runs queued tasks on the producer until there is room
+		Block // Sleeps until there is room. Workers help drain instead, a blocked worker would stop consuming
+	};
+
+	inline const char* GetWorkerGroupName(EWorkerGroup group)
+	{
+		switch (group)
+		{
+		case EWorkerGroup::Foreground: return "Foreground";
+		case EWorkerGroup::Background: return "Background";
+		case EWorkerGroup::BlockingIO: return "BlockingIO";
+		default: return "Unknown";
+		}
+	}
+
 	class ITaskQueue
 	{
 	public:
 		virtual ~ITaskQueue() = default;
 
 		virtual void Push(std::shared_ptr<JobTask> task) = 0;
+		// Fails while the queue holds its capacity and leaves the task with the caller, Push ignores the capacity
+		virtual bool TryPush(std::shared_ptr<JobTask>& task)
+		{
+			Push(std::move(task));
+			return true;
+		}
 		virtual std::shared_ptr<JobTask> Pop() = 0;
 		virtual std::shared_ptr<JobTask> Steal() = 0;
 		virtual void Clear() = 0;
 		virtual bool IsEmpty() const = 0;
 		virtual size_t Size() const = 0;
+		virtual size_t GetHighWaterMark() const { return 0; } // Largest size reached
+
+		// Tasks with a deadline are kept apart and popped earliest deadline first, before any other task
+		virtual std::chrono::steady_clock::time_point GetEarliestDeadline() const { return std::chrono::steady_clock::time_point::max(); }
+		virtual std::shared_ptr<JobTask> PopEarliestDeadline() { return nullptr; }
 	};
 
 	class IThreadRunnable
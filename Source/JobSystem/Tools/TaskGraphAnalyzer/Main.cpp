@@ -0,0 +1,115 @@
+// Offline analysis of a task graph capture saved with TaskGraph::Save
+// Usage: TaskGraphAnalyzer <capture> [profile bucket in us] [edge count]
+
+#include "Jobs/TaskGraph.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace SV;
+
+namespace
+{
+	constexpr int64_t DEFAULT_PROFILE_ROWS = 40;
+	constexpr size_t DEFAULT_EDGE_COUNT = 10;
+
+	double ToUs(int64_t ns)
+	{
+		return static_cast<double>(ns) / 1000.0;
+	}
+
+	double Percent(int64_t part, int64_t total)
+	{
+		return total > 0 ? 100.0 * static_cast<double>(part) / static_cast<double>(total) : 0.0;
+	}
+
+	std::string GetLabel(const TaskGraphNode& node)
+	{
+		return node.Label.empty() ? "Task_" + std::to_string(node.Id) : node.Label;
+	}
+
+	// False unless the whole argument is a number above zero
+	bool ParsePositive(const char* argument, int64_t& outValue)
+	{
+		const char* end = argument + std::strlen(argument);
+		const std::from_chars_result result = std::from_chars(argument, end, outValue);
+		return result.ec == std::errc() && result.ptr == end && outValue > 0;
+	}
+
+	int PrintUsage()
+	{
+		std::cout << "Usage: TaskGraphAnalyzer <capture> [profile bucket in us] [edge count]\n";
+		std::cout << "Bucket and edge count must be positive integers\n";
+		return 1;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	int64_t bucketArgumentUs = 0;
+	int64_t edgeCountArgument = static_cast<int64_t>(DEFAULT_EDGE_COUNT);
+	if (argc < 2 || (argc > 2 && !ParsePositive(argv[2], bucketArgumentUs)) || (argc > 3 && !ParsePositive(argv[3], edgeCountArgument)))
+	{
+		return PrintUsage();
+	}
+
+	TaskGraph graph;
+	if (!TaskGraph::Load(argv[1], graph))
+	{
+		std::cout << "[TaskGraphAnalyzer] Failed to load '" << argv[1] << "'\n";
+		return 1;
+	}
+
+	TaskGraphAnalysis analysis = AnalyzeTaskGraph(graph);
+	// Without a bucket size the profile is fit to a fixed number of rows
+	const int64_t bucketUs = argc > 2 ? bucketArgumentUs : std::max<int64_t>(1, analysis.SpanNs / 1000 / DEFAULT_PROFILE_ROWS);
+	analysis = AnalyzeTaskGraph(graph, std::chrono::microseconds(bucketUs));
+	const size_t edgeCount = static_cast<size_t>(edgeCountArgument);
+
+	size_t ranCount = 0;
+	for (const TaskGraphNode& node : graph.Nodes)
+	{
+		ranCount += node.HasRun() ? 1 : 0;
+	}
+
+	std::cout << std::fixed << std::setprecision(1);
+	std::cout << "Tasks: " << graph.Nodes.size() << " launched, " << ranCount << " ran\n";
+	std::cout << "Span: " << ToUs(analysis.SpanNs) << " us, work: " << ToUs(analysis.TotalWorkNs)
+		<< " us, average parallelism: " << std::setprecision(2) << analysis.AverageParallelism << std::setprecision(1) << "\n";
+
+	const int64_t pathNs = analysis.CriticalPathWorkNs + analysis.CriticalPathDelayNs;
+	std::cout << "\nCritical path: " << analysis.CriticalPath.size() << " tasks, "
+		<< "work " << ToUs(analysis.CriticalPathWorkNs) << " us (" << Percent(analysis.CriticalPathWorkNs, pathNs) << "%), "
+		<< "delay " << ToUs(analysis.CriticalPathDelayNs) << " us (" << Percent(analysis.CriticalPathDelayNs, pathNs) << "%)\n";
+	std::cout << "  " << std::left << std::setw(24) << "Task" << std::right << std::setw(8) << "Worker"
+		<< std::setw(12) << "Start us" << std::setw(12) << "Duration" << std::setw(12) << "Wait" << "\n";
+	const TaskGraphNode* previous = nullptr;
+	for (uint64_t id : analysis.CriticalPath)
+	{
+		const TaskGraphNode* node = graph.FindNode(id);
+		int64_t waitNs = node->StartTimeNs - (previous ? previous->EndTimeNs : node->ReadyTimeNs);
+		std::cout << "  " << std::left << std::setw(24) << GetLabel(*node) << std::right << std::setw(8) << node->WorkerId
+			<< std::setw(12) << ToUs(node->StartTimeNs) << std::setw(12) << ToUs(node->GetDurationNs()) << std::setw(12) << ToUs(waitNs) << "\n";
+		previous = node;
+	}
+
+	std::cout << "\nLongest scheduling delays:\n";
+	for (size_t i = 0; i < analysis.Edges.size() && i < edgeCount; ++i)
+	{
+		const TaskGraphEdge& edge = analysis.Edges[i];
+		std::cout << "  " << std::left << std::setw(24) << GetLabel(*graph.FindNode(edge.From)) << " -> "
+			<< std::setw(24) << GetLabel(*graph.FindNode(edge.To)) << std::right << std::setw(12) << ToUs(edge.DelayNs) << " us\n";
+	}
+
+	std::cout << "\nParallelism profile (" << bucketUs << " us buckets):\n";
+	for (const ParallelismSample& sample : analysis.Profile)
+	{
+		std::cout << "  " << std::setw(10) << ToUs(sample.TimeNs) << " us |" << std::string(static_cast<size_t>(sample.RunningTasks * 8.0 + 0.5), '#')
+			<< " " << std::setprecision(2) << sample.RunningTasks << std::setprecision(1) << "\n";
+	}
+	return 0;
+}
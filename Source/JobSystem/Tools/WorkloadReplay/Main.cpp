@@ -0,0 +1,230 @@
+// Replays a recorded workload on the current scheduler with busy-wait bodies of the recorded durations.
+// Record with TaskGraphRecorder and save with TaskGraph::SaveBinary (Save works too).
+// Tasks launched from inside another task are launched by its replayed body at the same offset, the rest are
+// launched from the main thread at their recorded time.
+// Usage: WorkloadReplay <workload> [worker count] [runs] [time scale]
+
+#include "Jobs/JobSystem.h"
+#include "Jobs/TaskGraph.h"
+#include "Platform/Platform.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace SV;
+
+namespace
+{
+	constexpr int32_t DEFAULT_RUN_COUNT = 3;
+	// Nested waits may put a few intervals between a spawn and the task that spawned it
+	constexpr int32_t MAX_PARENT_SEARCH = 64;
+
+	using Clock = std::chrono::steady_clock;
+
+	double ToUs(int64_t ns)
+	{
+		return static_cast<double>(ns) / 1000.0;
+	}
+
+	void BusyWaitUntil(Clock::time_point time)
+	{
+		while (Clock::now() < time)
+		{
+			Platform::CpuPause();
+		}
+	}
+
+	struct ReplayNode
+	{
+		std::vector<size_t> Prerequisites;
+		std::vector<size_t> Children; // Launched by this node's body, sorted by launch time
+		int64_t LaunchOffsetNs = 0; // From the parent's start, or from the replay start for roots
+		int64_t DurationNs = 0;
+		bool bRoot = true;
+	};
+
+	// Parent of a task launched on a worker is the task running on that worker at the time
+	std::vector<ReplayNode> BuildReplayNodes(const TaskGraph& graph, double timeScale)
+	{
+		std::vector<ReplayNode> nodes(graph.Nodes.size());
+		std::vector<std::vector<size_t>> executionsByWorker;
+		for (size_t i = 0; i < graph.Nodes.size(); ++i)
+		{
+			const TaskGraphNode& node = graph.Nodes[i];
+			nodes[i].DurationNs = node.HasRun() ? static_cast<int64_t>(node.GetDurationNs() * timeScale) : 0;
+			nodes[i].LaunchOffsetNs = static_cast<int64_t>(node.LaunchTimeNs * timeScale);
+			for (uint64_t prerequisiteId : node.Prerequisites)
+			{
+				if (const TaskGraphNode* prerequisite = graph.FindNode(prerequisiteId))
+				{
+					nodes[i].Prerequisites.push_back(static_cast<size_t>(prerequisite - graph.Nodes.data()));
+				}
+			}
+			if (node.HasRun() && node.WorkerId >= 0)
+			{
+				executionsByWorker.resize(std::max(executionsByWorker.size(), static_cast<size_t>(node.WorkerId) + 1));
+				executionsByWorker[node.WorkerId].push_back(i);
+			}
+		}
+		for (std::vector<size_t>& executions : executionsByWorker)
+		{
+			std::sort(executions.begin(), executions.end(),
+				[&graph](size_t a, size_t b) { return graph.Nodes[a].StartTimeNs < graph.Nodes[b].StartTimeNs; });
+		}
+
+		for (size_t i = 0; i < graph.Nodes.size(); ++i)
+		{
+			const TaskGraphNode& node = graph.Nodes[i];
+			if (node.SpawnWorkerId < 0 || static_cast<size_t>(node.SpawnWorkerId) >= executionsByWorker.size())
+			{
+				continue;
+			}
+			const std::vector<size_t>& executions = executionsByWorker[node.SpawnWorkerId];
+			auto it = std::upper_bound(executions.begin(), executions.end(), node.LaunchTimeNs,
+				[&graph](int64_t time, size_t index) { return time < graph.Nodes[index].StartTimeNs; });
+			for (int32_t step = 0; it != executions.begin() && step < MAX_PARENT_SEARCH; ++step)
+			{
+				const size_t parent = *--it;
+				const TaskGraphNode& parentNode = graph.Nodes[parent];
+				if (parent != i && parentNode.Id < node.Id && parentNode.EndTimeNs >= node.LaunchTimeNs)
+				{
+					nodes[i].bRoot = false;
+					nodes[i].LaunchOffsetNs = static_cast<int64_t>((node.LaunchTimeNs - parentNode.StartTimeNs) * timeScale);
+					nodes[parent].Children.push_back(i);
+					break;
+				}
+			}
+		}
+		for (ReplayNode& node : nodes)
+		{
+			std::sort(node.Children.begin(), node.Children.end(),
+				[&nodes](size_t a, size_t b) { return nodes[a].LaunchOffsetNs < nodes[b].LaunchOffsetNs; });
+		}
+		return nodes;
+	}
+
+	// One run, every task and event is created up front so launches can name prerequisites not launched yet
+	class WorkloadReplay
+	{
+	public:
+		WorkloadReplay(const TaskGraph& graph, const std::vector<ReplayNode>& nodes)
+			: m_Nodes(nodes)
+		{
+			m_Tasks.reserve(nodes.size());
+			m_Events.reserve(nodes.size());
+			for (size_t i = 0; i < nodes.size(); ++i)
+			{
+				TaskParams params;
+				params.Label = graph.Nodes[i].Label.empty() ? nullptr : graph.Nodes[i].Label.c_str();
+				m_Tasks.push_back(std::make_shared<JobTask>([this, i]() { RunBody(i); }, params));
+				m_Events.push_back(std::make_shared<TaskEvent>());
+				m_Tasks.back()->SetEvent(m_Events.back());
+			}
+		}
+
+		void Run()
+		{
+			std::vector<size_t> roots;
+			for (size_t i = 0; i < m_Nodes.size(); ++i)
+			{
+				if (m_Nodes[i].bRoot)
+				{
+					roots.push_back(i);
+				}
+			}
+			std::sort(roots.begin(), roots.end(),
+				[this](size_t a, size_t b) { return m_Nodes[a].LaunchOffsetNs < m_Nodes[b].LaunchOffsetNs; });
+
+			const Clock::time_point start = Clock::now();
+			for (size_t root : roots)
+			{
+				BusyWaitUntil(start + std::chrono::nanoseconds(m_Nodes[root].LaunchOffsetNs));
+				Launch(root);
+			}
+			TaskEvent::WaitAll(m_Events);
+		}
+
+	private:
+		void RunBody(size_t index)
+		{
+			const ReplayNode& node = m_Nodes[index];
+			const Clock::time_point start = Clock::now();
+			for (size_t child : node.Children)
+			{
+				BusyWaitUntil(start + std::chrono::nanoseconds(m_Nodes[child].LaunchOffsetNs));
+				Launch(child);
+			}
+			BusyWaitUntil(start + std::chrono::nanoseconds(node.DurationNs));
+		}
+
+		void Launch(size_t index)
+		{
+			std::vector<std::shared_ptr<TaskEvent>> prerequisites;
+			prerequisites.reserve(m_Nodes[index].Prerequisites.size());
+			for (size_t prerequisite : m_Nodes[index].Prerequisites)
+			{
+				prerequisites.push_back(m_Events[prerequisite]);
+			}
+			JobTask::Launch(m_Tasks[index], prerequisites);
+		}
+
+	private:
+		const std::vector<ReplayNode>& m_Nodes;
+		std::vector<std::shared_ptr<JobTask>> m_Tasks;
+		std::vector<std::shared_ptr<TaskEvent>> m_Events;
+	};
+
+	void PrintAnalysis(const std::string& name, const TaskGraphAnalysis& analysis)
+	{
+		std::cout << "  " << std::left << std::setw(12) << name << std::right
+			<< std::setw(12) << ToUs(analysis.SpanNs) << std::setw(12) << ToUs(analysis.TotalWorkNs)
+			<< std::setw(12) << std::setprecision(2) << analysis.AverageParallelism << std::setprecision(1)
+			<< std::setw(14) << ToUs(analysis.CriticalPathDelayNs) << "\n";
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		std::cout << "Usage: WorkloadReplay <workload> [worker count] [runs] [time scale]\n";
+		return 1;
+	}
+
+	TaskGraph recorded;
+	if (!TaskGraph::Load(argv[1], recorded))
+	{
+		std::cout << "[WorkloadReplay] Failed to load '" << argv[1] << "'\n";
+		return 1;
+	}
+	const int32_t workerCount = argc > 2 ? std::atoi(argv[2]) : -1;
+	const int32_t runCount = argc > 3 ? std::max(1, std::atoi(argv[3])) : DEFAULT_RUN_COUNT;
+	const double timeScale = argc > 4 ? std::atof(argv[4]) : 1.0;
+
+	const std::vector<ReplayNode> nodes = BuildReplayNodes(recorded, timeScale);
+	const size_t rootCount = std::count_if(nodes.begin(), nodes.end(), [](const ReplayNode& node) { return node.bRoot; });
+	std::cout << "Workload: " << recorded.Nodes.size() << " tasks, " << nodes.size() - rootCount << " launched from other tasks\n";
+
+	JobSystem::Initialize(workerCount);
+	std::cout << std::fixed << std::setprecision(1);
+	std::cout << "  " << std::left << std::setw(12) << "Run" << std::right << std::setw(12) << "Span us" << std::setw(12) << "Work us"
+		<< std::setw(12) << "Parallelism" << std::setw(14) << "Path delay us" << "\n";
+	PrintAnalysis("Recorded", AnalyzeTaskGraph(recorded));
+
+	TaskGraphRecorder& recorder = JobSystem::Get().GetGraphRecorder();
+	for (int32_t run = 0; run < runCount; ++run)
+	{
+		WorkloadReplay replay(recorded, nodes);
+		recorder.Begin();
+		replay.Run();
+		PrintAnalysis("Replay " + std::to_string(run + 1), AnalyzeTaskGraph(recorder.End()));
+	}
+
+	JobSystem::Shutdown();
+	return 0;
+}